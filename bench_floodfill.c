@@ -0,0 +1,124 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "bitboard.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Micro-benchmark del kernel de inundación de bitboard.h contra un BFS sobre
+// la grilla de enteros, con tableros aleatorios de distintos tamaños y
+// proporción de celdas ya capturadas.
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static unsigned int bfsFloodFill(const int *grid, unsigned int width, unsigned int height,
+                                 unsigned int start, unsigned char *seen, unsigned int *queue)
+{
+    memset(seen, 0, (size_t)width * height);
+    unsigned int head = 0, tail = 0;
+    queue[tail++] = start;
+    seen[start] = 1;
+    while (head < tail) {
+        unsigned int pos = queue[head++];
+        int x = (int)(pos % width), y = (int)(pos / width);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = x + dx, ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= (int)width || ny >= (int)height)
+                    continue;
+                unsigned int n = (unsigned int)ny * width + (unsigned int)nx;
+                if (!seen[n] && grid[n] > 0) {
+                    seen[n] = 1;
+                    queue[tail++] = n;
+                }
+            }
+        }
+    }
+    return tail;
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef FIXED_WIDTH
+    unsigned int sizes[] = {FIXED_WIDTH}; // variante especializada: solo su tamaño (cuadrado)
+#else
+    unsigned int sizes[] = {10, 32, 64, 100, 256, 512, 1000};
+#endif
+    double densities[] = {0.0, 0.3, 0.5};
+    double budget = argc > 1 ? atof(argv[1]) : 0.2; // segundos por caso
+
+    srand(1);
+    printf("%-10s %-8s %-10s %14s %14s %8s\n", "tablero", "ocupado", "alcanzadas", "bitboard(us)", "bfs(us)", "speedup");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        unsigned int W = sizes[s], H = sizes[s];
+        size_t cells = (size_t)W * H;
+        int *grid = malloc(cells * sizeof(int));
+        unsigned char *seen = malloc(cells);
+        unsigned int *queue = malloc(cells * sizeof(unsigned int));
+        Bitboard freeCells, region;
+        if (grid == NULL || seen == NULL || queue == NULL ||
+            !bbInit(&freeCells, W, H) || !bbInit(&region, W, H)) {
+            fprintf(stderr, "Sin memoria para el tablero %ux%u\n", W, H);
+            return 1;
+        }
+
+        for (size_t d = 0; d < sizeof(densities) / sizeof(densities[0]); d++) {
+            bbClear(&freeCells);
+            for (unsigned int i = 0; i < cells; i++) {
+                grid[i] = ((double)rand() / RAND_MAX) < densities[d] ? 0 : (rand() % 9) + 1;
+            }
+            unsigned int start = (H / 2) * W + W / 2;
+            grid[start] = 1;
+            for (unsigned int y = 0; y < H; y++)
+                for (unsigned int x = 0; x < W; x++)
+                    if (grid[y * W + x] > 0)
+                        bbSet(&freeCells, x, y);
+
+            unsigned int reachedBb = 0, reachedBfs = 0;
+            unsigned long iterations = 0;
+            double t0 = nowSeconds(), elapsed;
+            do {
+                bbClear(&region);
+                bbSet(&region, W / 2, H / 2);
+                reachedBb = bbFloodFill(&region, &freeCells);
+                iterations++;
+                elapsed = nowSeconds() - t0;
+            } while (elapsed < budget);
+            double bbMicros = elapsed * 1e6 / (double)iterations;
+
+            iterations = 0;
+            t0 = nowSeconds();
+            do {
+                reachedBfs = bfsFloodFill(grid, W, H, start, seen, queue);
+                iterations++;
+                elapsed = nowSeconds() - t0;
+            } while (elapsed < budget);
+            double bfsMicros = elapsed * 1e6 / (double)iterations;
+
+            if (reachedBb != reachedBfs) {
+                fprintf(stderr, "Resultados distintos en %ux%u: bitboard=%u bfs=%u\n", W, H, reachedBb, reachedBfs);
+                return 1;
+            }
+
+            char label[32], density[16];
+            snprintf(label, sizeof(label), "%ux%u", W, H);
+            snprintf(density, sizeof(density), "%.0f%%", densities[d] * 100);
+            printf("%-10s %-8s %-10u %14.2f %14.2f %7.1fx\n", label, density, reachedBb,
+                   bbMicros, bfsMicros, bfsMicros / bbMicros);
+        }
+
+        bbFree(&freeCells);
+        bbFree(&region);
+        free(grid);
+        free(seen);
+        free(queue);
+    }
+    return 0;
+}
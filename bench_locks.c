@@ -0,0 +1,351 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "estructuras.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Micro-benchmark de la sincronización entre procesos sobre el estado del juego:
+// 1..N procesos lectores copian la grilla en bucle (como mirrorGrid) mientras un
+// proceso escritor modifica una celda cada cierto intervalo (como el master al
+// aplicar un movimiento). Se compara el lock de estructuras.h con
+// pthread_rwlock_t compartido entre procesos, un seqlock y un lock sobre futex.
+// Para cada primitiva informa lecturas por segundo y cuánto espera el escritor
+// para entrar; los lectores verifican además que no vean escrituras a medias.
+
+#define BENCH_MAX_READERS 16
+#define BENCH_LATENCY_SAMPLES 65536
+
+typedef enum
+{
+    LOCK_REPO,
+    LOCK_PTHREAD,
+    LOCK_PTHREAD_WRITER,
+    LOCK_SEQLOCK,
+    LOCK_FUTEX,
+    LOCK_KINDS
+} LockKind;
+
+static const char *lockNames[LOCK_KINDS] = {
+    "semaforos (repo)", "pthread_rwlock", "pthread_rwlock escritor", "seqlock", "futex rwlock"};
+
+// Futex: bits 0..29 lectores adentro, bit 30 escritor esperando, bit 31 escritor adentro
+#define FUTEX_WRITER 0x80000000u
+#define FUTEX_WAITING 0x40000000u
+#define FUTEX_READERS 0x3FFFFFFFu
+
+typedef struct
+{
+    unsigned long reads;
+    unsigned long torn; // copias con la primera y la última celda distintas
+    char padding[48];
+} ReaderStats;
+
+typedef struct
+{
+    Semaphores semaphores;
+    pthread_rwlock_t rwlock;
+    uint32_t futexWord;
+    uint32_t sequence;
+    volatile int running;
+    volatile int stop;
+    ReaderStats readers[BENCH_MAX_READERS];
+    unsigned long writes;
+    unsigned int latencyCount;
+    unsigned int latencyMicros[BENCH_LATENCY_SAMPLES]; // espera del escritor por adquisición
+    int grid[];
+} BenchShared;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static long futexCall(uint32_t *word, int op, uint32_t value)
+{
+    return syscall(SYS_futex, word, op, value, NULL, NULL, 0);
+}
+
+static void futexReadLock(uint32_t *word)
+{
+    while (1) {
+        uint32_t state = __atomic_load_n(word, __ATOMIC_RELAXED);
+        if (state & (FUTEX_WRITER | FUTEX_WAITING)) {
+            futexCall(word, FUTEX_WAIT, state);
+        } else if (__atomic_compare_exchange_n(word, &state, state + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+static void futexReadUnlock(uint32_t *word)
+{
+    uint32_t state = __atomic_sub_fetch(word, 1, __ATOMIC_RELEASE);
+    if ((state & FUTEX_READERS) == 0 && (state & FUTEX_WAITING)) {
+        futexCall(word, FUTEX_WAKE, INT_MAX);
+    }
+}
+
+// Un solo escritor: anuncia que espera (frena a los lectores nuevos) y entra cuando salen todos
+static void futexWriteLock(uint32_t *word)
+{
+    __atomic_fetch_or(word, FUTEX_WAITING, __ATOMIC_RELAXED);
+    while (1) {
+        uint32_t state = __atomic_load_n(word, __ATOMIC_RELAXED);
+        if ((state & FUTEX_READERS) == 0) {
+            if (__atomic_compare_exchange_n(word, &state, FUTEX_WRITER, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return;
+            }
+        } else {
+            futexCall(word, FUTEX_WAIT, state);
+        }
+    }
+}
+
+static void futexWriteUnlock(uint32_t *word)
+{
+    __atomic_store_n(word, 0, __ATOMIC_RELEASE);
+    futexCall(word, FUTEX_WAKE, INT_MAX);
+}
+
+static void readerLoop(BenchShared *shared, LockKind kind, unsigned int cells, int *copy, ReaderStats *stats)
+{
+    while (!shared->running)
+        ;
+    while (!shared->stop) {
+        switch (kind) {
+        case LOCK_REPO:
+            acquireGameStatePlayerLock(&shared->semaphores);
+            memcpy(copy, shared->grid, cells * sizeof(int));
+            releaseGameStatePlayerLock(&shared->semaphores);
+            break;
+        case LOCK_PTHREAD:
+        case LOCK_PTHREAD_WRITER:
+            pthread_rwlock_rdlock(&shared->rwlock);
+            memcpy(copy, shared->grid, cells * sizeof(int));
+            pthread_rwlock_unlock(&shared->rwlock);
+            break;
+        case LOCK_SEQLOCK: {
+            uint32_t before, after;
+            do {
+                while ((before = __atomic_load_n(&shared->sequence, __ATOMIC_ACQUIRE)) & 1)
+                    ;
+                memcpy(copy, shared->grid, cells * sizeof(int));
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                after = __atomic_load_n(&shared->sequence, __ATOMIC_RELAXED);
+            } while (before != after);
+            break;
+        }
+        case LOCK_FUTEX:
+            futexReadLock(&shared->futexWord);
+            memcpy(copy, shared->grid, cells * sizeof(int));
+            futexReadUnlock(&shared->futexWord);
+            break;
+        default:
+            break;
+        }
+        if (copy[0] != copy[cells - 1]) {
+            stats->torn++;
+        }
+        stats->reads++;
+    }
+}
+
+static void writerLoop(BenchShared *shared, LockKind kind, unsigned int cells, unsigned int intervalMicros)
+{
+    struct timespec pause = {0, (long)intervalMicros * 1000};
+    int value = 0;
+    while (!shared->running)
+        ;
+    while (!shared->stop) {
+        double requested = nowSeconds();
+        value++;
+        switch (kind) {
+        case LOCK_REPO:
+            masterEnters(&shared->semaphores);
+            break;
+        case LOCK_PTHREAD:
+        case LOCK_PTHREAD_WRITER:
+            pthread_rwlock_wrlock(&shared->rwlock);
+            break;
+        case LOCK_SEQLOCK:
+            __atomic_store_n(&shared->sequence, shared->sequence + 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            break;
+        case LOCK_FUTEX:
+            futexWriteLock(&shared->futexWord);
+            break;
+        default:
+            break;
+        }
+        double acquired = nowSeconds();
+
+        // Primera y última celda siempre iguales fuera de la sección crítica
+        shared->grid[0] = value;
+        shared->grid[cells / 2] = value;
+        shared->grid[cells - 1] = value;
+
+        switch (kind) {
+        case LOCK_REPO:
+            masterLeaves(&shared->semaphores);
+            break;
+        case LOCK_PTHREAD:
+        case LOCK_PTHREAD_WRITER:
+            pthread_rwlock_unlock(&shared->rwlock);
+            break;
+        case LOCK_SEQLOCK:
+            __atomic_store_n(&shared->sequence, shared->sequence + 1, __ATOMIC_RELEASE);
+            break;
+        case LOCK_FUTEX:
+            futexWriteUnlock(&shared->futexWord);
+            break;
+        default:
+            break;
+        }
+
+        if (shared->latencyCount < BENCH_LATENCY_SAMPLES) {
+            shared->latencyMicros[shared->latencyCount++] = (unsigned int)((acquired - requested) * 1e6);
+        }
+        shared->writes++;
+        if (intervalMicros > 0) {
+            nanosleep(&pause, NULL);
+        }
+    }
+}
+
+static void initLock(BenchShared *shared, LockKind kind)
+{
+    sem_init(&shared->semaphores.mutexMasterAccess, 1, 1);
+    sem_init(&shared->semaphores.mutexGameState, 1, 1);
+    sem_init(&shared->semaphores.mutexPlayerAccess, 1, 1);
+    shared->semaphores.playersReadingState = 0;
+
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    if (kind == LOCK_PTHREAD_WRITER) {
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    }
+    pthread_rwlock_init(&shared->rwlock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+
+    shared->futexWord = 0;
+    shared->sequence = 0;
+}
+
+static void destroyLock(BenchShared *shared)
+{
+    sem_destroy(&shared->semaphores.mutexMasterAccess);
+    sem_destroy(&shared->semaphores.mutexGameState);
+    sem_destroy(&shared->semaphores.mutexPlayerAccess);
+    pthread_rwlock_destroy(&shared->rwlock);
+}
+
+static int compareUnsigned(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int maxReaders = 4, cells = 100 * 100, intervalMicros = 100;
+    double seconds = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            maxReaders = (unsigned int)atoi(argv[++i]);
+            if (maxReaders < 1 || maxReaders > BENCH_MAX_READERS)
+                maxReaders = BENCH_MAX_READERS;
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cells = (unsigned int)atoi(argv[++i]);
+            if (cells < 2)
+                cells = 2;
+        } else if (!strcmp(argv[i], "-i") && i + 1 < argc) {
+            intervalMicros = (unsigned int)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Uso: %s [-r max_lectores] [-t segundos] [-c celdas] [-i intervalo_escritor_us]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    size_t sharedSize = sizeof(BenchShared) + (size_t)cells * sizeof(int);
+    BenchShared *shared = mmap(NULL, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    int *copy = malloc((size_t)cells * sizeof(int));
+    if (shared == MAP_FAILED || copy == NULL) {
+        fprintf(stderr, "Sin memoria para el benchmark\n");
+        return 1;
+    }
+
+    printf("grilla de %u celdas, escritor cada %u us, %.2f s por caso\n", cells, intervalMicros, seconds);
+    printf("%-24s %8s %14s %10s %10s %10s %10s %8s\n", "primitiva", "lectores", "lecturas/s", "escrituras",
+           "p50(us)", "p99(us)", "max(us)", "rotas");
+
+    for (int kind = 0; kind < LOCK_KINDS; kind++) {
+        for (unsigned int readers = 1; readers <= maxReaders; readers *= 2) {
+            memset(shared, 0, sharedSize);
+            initLock(shared, (LockKind)kind);
+
+            pid_t pids[BENCH_MAX_READERS + 1];
+            for (unsigned int r = 0; r <= readers; r++) {
+                pids[r] = fork();
+                if (pids[r] == -1) {
+                    perror("fork");
+                    return 1;
+                }
+                if (pids[r] == 0) {
+                    if (r < readers)
+                        readerLoop(shared, (LockKind)kind, cells, copy, &shared->readers[r]);
+                    else
+                        writerLoop(shared, (LockKind)kind, cells, intervalMicros);
+                    _exit(0);
+                }
+            }
+
+            shared->running = 1;
+            double start = nowSeconds();
+            struct timespec budget = {(time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)};
+            nanosleep(&budget, NULL);
+            shared->stop = 1;
+            // Si el escritor quedó esperando a un lector, los lectores terminan igual
+            // porque revisan stop al salir de la sección crítica
+            for (unsigned int r = 0; r <= readers; r++)
+                waitpid(pids[r], NULL, 0);
+            double elapsed = nowSeconds() - start;
+
+            unsigned long reads = 0, torn = 0;
+            for (unsigned int r = 0; r < readers; r++) {
+                reads += shared->readers[r].reads;
+                torn += shared->readers[r].torn;
+            }
+            unsigned int samples = shared->latencyCount;
+            qsort(shared->latencyMicros, samples, sizeof(unsigned int), compareUnsigned);
+            unsigned int p50 = samples ? shared->latencyMicros[samples / 2] : 0;
+            unsigned int p99 = samples ? shared->latencyMicros[(unsigned int)(samples * 0.99)] : 0;
+            unsigned int max = samples ? shared->latencyMicros[samples - 1] : 0;
+
+            printf("%-24s %8u %14.0f %10lu %10u %10u %10u %8lu\n", lockNames[kind], readers, reads / elapsed,
+                   shared->writes, p50, p99, max, torn);
+            fflush(stdout);
+            destroyLock(shared);
+        }
+    }
+
+    munmap(shared, sharedSize);
+    free(copy);
+    return 0;
+}
@@ -0,0 +1,259 @@
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tablero de bits: un bit por celda, filas rellenadas a palabras de 64 bits.
+// La columna x de la fila y vive en el bit x % 64 de la palabra
+// y * wordsPerRow + x / 64. Los bits de relleno al final de cada fila quedan
+// siempre en 0 mientras las operaciones se enmascaren con un tablero válido.
+
+// Con FIXED_WIDTH/FIXED_HEIGHT (variantes especializadas) todos los tableros del
+// programa tienen esas dimensiones y los recorridos usan constantes; bbInit
+// rechaza cualquier otro tamaño.
+#ifdef FIXED_WIDTH
+#define BB_WIDTH(bb) ((unsigned int)FIXED_WIDTH)
+#define BB_WORDS(bb) ((unsigned int)(FIXED_WIDTH + 63) / 64)
+#else
+#define BB_WIDTH(bb) ((bb)->width)
+#define BB_WORDS(bb) ((bb)->wordsPerRow)
+#endif
+#ifdef FIXED_HEIGHT
+#define BB_HEIGHT(bb) ((unsigned int)FIXED_HEIGHT)
+#else
+#define BB_HEIGHT(bb) ((bb)->height)
+#endif
+
+typedef struct
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int wordsPerRow;
+    uint64_t *bits;
+    uint64_t *scratch; // dos filas auxiliares para la expansión
+} Bitboard;
+
+static inline bool bbInit(Bitboard *bb, unsigned int width, unsigned int height)
+{
+    bb->width = width;
+    bb->height = height;
+    bb->wordsPerRow = (width + 63) / 64;
+    bb->bits = bb->scratch = NULL;
+    if (BB_WIDTH(bb) != width || BB_HEIGHT(bb) != height)
+        return false; // variante especializada para otro tamaño
+    bb->bits = calloc((size_t)bb->wordsPerRow * height, sizeof(uint64_t));
+    bb->scratch = calloc((size_t)bb->wordsPerRow * 2, sizeof(uint64_t));
+    if (bb->bits == NULL || bb->scratch == NULL) {
+        free(bb->bits);
+        free(bb->scratch);
+        bb->bits = bb->scratch = NULL;
+        return false;
+    }
+    return true;
+}
+
+static inline void bbFree(Bitboard *bb)
+{
+    free(bb->bits);
+    free(bb->scratch);
+    bb->bits = bb->scratch = NULL;
+}
+
+static inline void bbClear(Bitboard *bb)
+{
+    memset(bb->bits, 0, (size_t)BB_WORDS(bb) * BB_HEIGHT(bb) * sizeof(uint64_t));
+}
+
+static inline void bbCopy(Bitboard *dst, const Bitboard *src)
+{
+    memcpy(dst->bits, src->bits, (size_t)BB_WORDS(src) * BB_HEIGHT(src) * sizeof(uint64_t));
+}
+
+static inline uint64_t *bbRow(const Bitboard *bb, unsigned int y)
+{
+    return bb->bits + (size_t)y * BB_WORDS(bb);
+}
+
+static inline void bbSet(Bitboard *bb, unsigned int x, unsigned int y)
+{
+    bbRow(bb, y)[x >> 6] |= 1ULL << (x & 63);
+}
+
+static inline void bbReset(Bitboard *bb, unsigned int x, unsigned int y)
+{
+    bbRow(bb, y)[x >> 6] &= ~(1ULL << (x & 63));
+}
+
+static inline bool bbTest(const Bitboard *bb, unsigned int x, unsigned int y)
+{
+    return (bbRow(bb, y)[x >> 6] >> (x & 63)) & 1;
+}
+
+static inline unsigned int bbCount(const Bitboard *bb)
+{
+    unsigned int count = 0;
+    size_t words = (size_t)BB_WORDS(bb) * BB_HEIGHT(bb);
+    for (size_t i = 0; i < words; i++)
+        count += (unsigned int)__builtin_popcountll(bb->bits[i]);
+    return count;
+}
+
+static inline unsigned int bbCountAnd(const Bitboard *a, const Bitboard *b)
+{
+    unsigned int count = 0;
+    size_t words = (size_t)BB_WORDS(a) * BB_HEIGHT(a);
+    for (size_t i = 0; i < words; i++)
+        count += (unsigned int)__builtin_popcountll(a->bits[i] & b->bits[i]);
+    return count;
+}
+
+static inline void bbOr(Bitboard *dst, const Bitboard *src)
+{
+    size_t words = (size_t)BB_WORDS(dst) * BB_HEIGHT(dst);
+    for (size_t i = 0; i < words; i++)
+        dst->bits[i] |= src->bits[i];
+}
+
+static inline void bbAnd(Bitboard *dst, const Bitboard *src)
+{
+    size_t words = (size_t)BB_WORDS(dst) * BB_HEIGHT(dst);
+    for (size_t i = 0; i < words; i++)
+        dst->bits[i] &= src->bits[i];
+}
+
+static inline void bbAndNot(Bitboard *dst, const Bitboard *src)
+{
+    size_t words = (size_t)BB_WORDS(dst) * BB_HEIGHT(dst);
+    for (size_t i = 0; i < words; i++)
+        dst->bits[i] &= ~src->bits[i];
+}
+
+static inline bool bbIsEmpty(const Bitboard *bb)
+{
+    size_t words = (size_t)BB_WORDS(bb) * BB_HEIGHT(bb);
+    for (size_t i = 0; i < words; i++)
+        if (bb->bits[i])
+            return false;
+    return true;
+}
+
+// dst = src | src desplazada una columna a cada lado (con acarreo entre palabras)
+static inline void bbRowDilate(const uint64_t *src, uint64_t *dst, unsigned int words)
+{
+    for (unsigned int k = 0; k < words; k++) {
+        uint64_t toRight = (src[k] << 1) | (k > 0 ? src[k - 1] >> 63 : 0);
+        uint64_t toLeft = (src[k] >> 1) | (k + 1 < words ? src[k + 1] << 63 : 0);
+        dst[k] = src[k] | toRight | toLeft;
+    }
+}
+
+// dst = src expandido un paso en la vecindad de 8 (sin enmascarar)
+static inline void bbDilate(Bitboard *dst, const Bitboard *src)
+{
+    unsigned int words = BB_WORDS(src);
+    uint64_t *acc = dst->scratch;
+    for (unsigned int y = 0; y < BB_HEIGHT(src); y++) {
+        const uint64_t *row = bbRow(src, y);
+        const uint64_t *above = y > 0 ? bbRow(src, y - 1) : NULL;
+        const uint64_t *below = y + 1 < BB_HEIGHT(src) ? bbRow(src, y + 1) : NULL;
+        for (unsigned int k = 0; k < words; k++)
+            acc[k] = row[k] | (above ? above[k] : 0) | (below ? below[k] : 0);
+        bbRowDilate(acc, bbRow(dst, y), words);
+    }
+}
+
+// Expande una fila de la región con la vecindad de 8 y la cierra horizontalmente
+// dentro de las celdas libres. Devuelve true si la fila cambió.
+static inline bool bbFloodRow(Bitboard *region, const Bitboard *freeCells, unsigned int y)
+{
+    unsigned int words = BB_WORDS(region);
+    uint64_t *row = bbRow(region, y);
+    const uint64_t *above = y > 0 ? bbRow(region, y - 1) : NULL;
+    const uint64_t *below = y + 1 < BB_HEIGHT(region) ? bbRow(region, y + 1) : NULL;
+    const uint64_t *mask = bbRow(freeCells, y);
+    uint64_t *acc = region->scratch;
+    uint64_t *next = region->scratch + words;
+
+    uint64_t any = 0;
+    for (unsigned int k = 0; k < words; k++) {
+        acc[k] = row[k] | (above ? above[k] : 0) | (below ? below[k] : 0);
+        any |= acc[k];
+    }
+    if (!any)
+        return false;
+
+    bool grew = true;
+    bbRowDilate(acc, next, words);
+    for (unsigned int k = 0; k < words; k++)
+        acc[k] = next[k] & mask[k];
+    while (grew) {
+        grew = false;
+        bbRowDilate(acc, next, words);
+        for (unsigned int k = 0; k < words; k++) {
+            uint64_t v = next[k] & mask[k];
+            if (v != acc[k]) {
+                acc[k] = v;
+                grew = true;
+            }
+        }
+    }
+
+    bool changed = false;
+    for (unsigned int k = 0; k < words; k++) {
+        if (acc[k] != row[k]) {
+            row[k] = acc[k];
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Inunda region (que contiene las semillas) dentro de freeCells con vecindad de 8.
+// Alterna barridos descendentes y ascendentes hasta que no hay cambios, así que
+// una pasada propaga todo un corredor vertical u horizontal de una vez.
+// Devuelve la cantidad de celdas alcanzadas.
+static inline unsigned int bbFloodFill(Bitboard *region, const Bitboard *freeCells)
+{
+    size_t words = (size_t)BB_WORDS(region) * BB_HEIGHT(region);
+    for (size_t i = 0; i < words; i++)
+        region->bits[i] &= freeCells->bits[i];
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (unsigned int y = 0; y < BB_HEIGHT(region); y++)
+            changed |= bbFloodRow(region, freeCells, y);
+        if (!changed)
+            break;
+        changed = false;
+        for (unsigned int y = BB_HEIGHT(region); y-- > 0;)
+            changed |= bbFloodRow(region, freeCells, y);
+    }
+    return bbCount(region);
+}
+
+// Celdas libres alcanzables desde una cabeza en (x, y), sin contar la cabeza.
+static inline unsigned int bbReachableFrom(Bitboard *region, const Bitboard *freeCells, unsigned int x, unsigned int y)
+{
+    bbClear(region);
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int nx = (int)x + dx, ny = (int)y + dy;
+            if ((dx || dy) && nx >= 0 && ny >= 0 && nx < (int)BB_WIDTH(region) && ny < (int)BB_HEIGHT(region))
+                bbSet(region, (unsigned int)nx, (unsigned int)ny);
+        }
+    }
+    return bbFloodFill(region, freeCells);
+}
+
+// Una región está aislada si ninguna de las cabezas marcadas en heads es vecina
+// de alguna de sus celdas, es decir, nadie más puede entrar a disputarla.
+static inline bool bbRegionIsolated(const Bitboard *region, const Bitboard *heads, Bitboard *scratch)
+{
+    bbDilate(scratch, region);
+    return bbCountAnd(scratch, heads) == 0;
+}
+
+#endif
@@ -0,0 +1,401 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include "estructuras.h"
+#include "espectador.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Servidor de espectadores. Se engancha al master como vista (-v ./espectador):
+// en cada pendingView copia el GameState bajo el lock de lectores y avisa que
+// terminó, así que el costo para el master es una copia de memoria sin importar
+// cuántos suscriptores haya. El diff y el envío a los sockets se hacen fuera del handshake.
+
+#define MAX_PENDING_BYTES (1u << 20) // cota del buffer de salida por cliente
+#define IDLE_POLL_MS 50               // espera máxima entre rondas para atender sockets
+#define FINAL_DRAIN_MS 1000           // tiempo para vaciar buffers al terminar el juego
+
+typedef struct
+{
+    int fd;
+    bool needsKeyframe;
+    char *pending;       // mensajes aún no enviados; pending[0] es inicio de mensaje
+    size_t pendingLen;
+    size_t pendingCap;
+    size_t sentOfHead;   // bytes ya enviados del primer mensaje del buffer
+} Spectator;
+
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t cap;
+} MessageBuffer;
+
+static Spectator *spectators = NULL;
+static size_t spectatorsCount = 0, spectatorsCap = 0;
+static size_t pendingLimit = MAX_PENDING_BYTES;
+
+int openListenSocket(const char *path);
+void acceptSpectators(int listenFd);
+void buildKeyframe(MessageBuffer *msg, const GameState *state, uint32_t round);
+void buildDelta(MessageBuffer *msg, const GameState *prev, const GameState *state, uint32_t round);
+void enqueueMessage(Spectator *spectator, const MessageBuffer *msg);
+bool flushSpectator(Spectator *spectator);
+void removeClosedSpectators(void);
+bool anyPendingOutput(void);
+
+static void bufferAppend(MessageBuffer *msg, const void *data, size_t len)
+{
+    if (msg->len + len > msg->cap) {
+        size_t newCap = msg->cap ? msg->cap * 2 : 4096;
+        while (newCap < msg->len + len)
+            newCap *= 2;
+        char *grown = realloc(msg->data, newCap);
+        if (grown == NULL) {
+            fprintf(stderr, "espectador: sin memoria para el mensaje\n");
+            exit(1);
+        }
+        msg->data = grown;
+        msg->cap = newCap;
+    }
+    memcpy(msg->data + msg->len, data, len);
+    msg->len += len;
+}
+
+static int sleepUntilNextRound(Semaphores *semaphores, int ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return sem_timedwait(&semaphores->pendingView, &deadline);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <width> <height> [socket]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned int width = atoi(argv[1]);
+    unsigned int height = atoi(argv[2]);
+    const char *path = argc > 3 ? argv[3] : SPECTATOR_DEFAULT_PATH;
+
+    GameState *gameState = connectToSharedMemoryState(width, height);
+    Semaphores *semaphores = connectToSharedMemorySemaphores();
+    // La ronda del master sale de las pistas; sin ellas se numeran los cuadros propios
+    HintIndex *hints = connectToSharedMemoryHints();
+
+    signal(SIGPIPE, SIG_IGN);
+    int listenFd = openListenSocket(path);
+    if (listenFd == -1)
+        return 1;
+
+    size_t stateSize = sizeof(GameState) + (size_t)width * height * sizeof(int);
+    if (pendingLimit < 2 * stateSize)
+        pendingLimit = 2 * stateSize; // siempre tiene que caber al menos un keyframe
+    GameState *previous = malloc(stateSize);
+    GameState *current = malloc(stateSize);
+    if (previous == NULL || current == NULL) {
+        fprintf(stderr, "espectador: sin memoria para las copias del estado\n");
+        return 1;
+    }
+
+    MessageBuffer keyframe = {0}, delta = {0};
+    uint32_t round = 0;
+    bool havePrevious = false;
+    bool gameOver = false;
+
+    while (!gameOver)
+    {
+        if (sleepUntilNextRound(semaphores, IDLE_POLL_MS) == -1) {
+            if (errno != ETIMEDOUT && errno != EINTR) {
+                fprintf(stderr, "espectador: sem_timedwait pendingView fallo errno=%d (%s)\n", errno, strerror(errno));
+                break;
+            }
+            // Sin ronda nueva: se atienden conexiones y buffers pendientes
+            acceptSpectators(listenFd);
+            for (size_t i = 0; i < spectatorsCount; i++)
+                flushSpectator(&spectators[i]);
+            removeClosedSpectators();
+            continue;
+        }
+
+        // Única lectura del estado compartido por cuadro, bajo el lock de lectores
+        // porque el master sigue jugando mientras tanto
+        acquireGameStatePlayerLock(semaphores);
+        memcpy(current, gameState, stateSize);
+        round = hints != NULL ? hints->round : round + 1;
+        releaseGameStatePlayerLock(semaphores);
+        if (sem_post(&semaphores->viewEndedPrinting) == -1) {
+            fprintf(stderr, "espectador: sem_post viewEndedPrinting fallo errno=%d (%s)\n", errno, strerror(errno));
+        }
+        gameOver = current->gameOver;
+
+        acceptSpectators(listenFd);
+
+        keyframe.len = 0;
+        delta.len = 0;
+        if (havePrevious)
+            buildDelta(&delta, previous, current, round);
+
+        for (size_t i = 0; i < spectatorsCount; i++) {
+            Spectator *spectator = &spectators[i];
+            if (spectator->needsKeyframe || !havePrevious) {
+                if (keyframe.len == 0)
+                    buildKeyframe(&keyframe, current, round);
+                enqueueMessage(spectator, &keyframe);
+            } else {
+                enqueueMessage(spectator, &delta);
+            }
+            flushSpectator(spectator);
+        }
+        removeClosedSpectators();
+
+        GameState *swap = previous;
+        previous = current;
+        current = swap;
+        havePrevious = true;
+    }
+
+    // Último intento de entregar lo pendiente antes de cerrar
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        for (size_t i = 0; i < spectatorsCount; i++)
+            flushSpectator(&spectators[i]);
+        removeClosedSpectators();
+        if (!anyPendingOutput())
+            break;
+        poll(NULL, 0, 10);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < FINAL_DRAIN_MS);
+
+    for (size_t i = 0; i < spectatorsCount; i++) {
+        close(spectators[i].fd);
+        free(spectators[i].pending);
+    }
+    free(spectators);
+    free(keyframe.data);
+    free(delta.data);
+    free(previous);
+    free(current);
+    close(listenFd);
+    unlink(path);
+
+    return 0;
+}
+
+int openListenSocket(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "espectador: ruta de socket demasiado larga: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("espectador: socket");
+        return -1;
+    }
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 || listen(fd, 64) == -1) {
+        fprintf(stderr, "espectador: no se pudo escuchar en %s (errno=%d %s)\n", path, errno, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void acceptSpectators(int listenFd)
+{
+    int fd;
+    while ((fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1) {
+        if (spectatorsCount == spectatorsCap) {
+            size_t newCap = spectatorsCap ? spectatorsCap * 2 : 8;
+            Spectator *grown = realloc(spectators, newCap * sizeof(Spectator));
+            if (grown == NULL) {
+                close(fd);
+                continue;
+            }
+            spectators = grown;
+            spectatorsCap = newCap;
+        }
+        Spectator *spectator = &spectators[spectatorsCount++];
+        memset(spectator, 0, sizeof(*spectator));
+        spectator->fd = fd;
+        spectator->needsKeyframe = true;
+    }
+}
+
+void buildKeyframe(MessageBuffer *msg, const GameState *state, uint32_t round)
+{
+    uint32_t cells = (uint32_t)state->width * state->height;
+    SpectatorMessageHeader header = {0};
+    header.round = round;
+    header.type = SPECTATOR_KEYFRAME;
+    header.gameOver = state->gameOver;
+    header.playersMask = (uint16_t)((1u << state->playersNumber) - 1);
+    header.cellsCount = cells;
+    header.width = state->width;
+    header.height = state->height;
+    header.length = sizeof(header) + state->playersNumber * sizeof(Player) + cells * sizeof(int32_t);
+
+    msg->len = 0;
+    bufferAppend(msg, &header, sizeof(header));
+    bufferAppend(msg, state->players, state->playersNumber * sizeof(Player));
+    bufferAppend(msg, state->grid, cells * sizeof(int32_t));
+}
+
+void buildDelta(MessageBuffer *msg, const GameState *prev, const GameState *state, uint32_t round)
+{
+    SpectatorMessageHeader header = {0};
+    header.round = round;
+    header.type = SPECTATOR_DELTA;
+    header.gameOver = state->gameOver;
+    header.width = state->width;
+    header.height = state->height;
+
+    // El encabezado se completa al final, cuando se conocen los conteos
+    msg->len = 0;
+    bufferAppend(msg, &header, sizeof(header));
+
+    for (unsigned int i = 0; i < state->playersNumber; i++) {
+        if (memcmp(&prev->players[i], &state->players[i], sizeof(Player)) != 0) {
+            header.playersMask |= (uint16_t)(1u << i);
+            bufferAppend(msg, &state->players[i], sizeof(Player));
+        }
+    }
+
+    uint32_t cells = (uint32_t)state->width * state->height;
+    for (uint32_t i = 0; i < cells; i++) {
+        if (prev->grid[i] != state->grid[i]) {
+            SpectatorCell cell = {i, state->grid[i]};
+            bufferAppend(msg, &cell, sizeof(cell));
+            header.cellsCount++;
+        }
+    }
+
+    header.length = (uint32_t)msg->len;
+    memcpy(msg->data, &header, sizeof(header));
+}
+
+void enqueueMessage(Spectator *spectator, const MessageBuffer *msg)
+{
+    if (spectator->fd == -1)
+        return;
+
+    if (spectator->pendingLen + msg->len > pendingLimit && spectator->pendingLen > 0) {
+        // Cliente lento: se descartan los mensajes que no empezó a recibir
+        // (el que está a medio enviar se conserva para no romper el stream)
+        // y se lo resincroniza con un keyframe.
+        size_t keep = 0;
+        if (spectator->sentOfHead > 0) {
+            SpectatorMessageHeader head;
+            memcpy(&head, spectator->pending, sizeof(head));
+            keep = head.length;
+        }
+        spectator->pendingLen = keep;
+        spectator->needsKeyframe = true;
+        return;
+    }
+
+    if (spectator->pendingLen + msg->len > spectator->pendingCap) {
+        size_t newCap = spectator->pendingCap ? spectator->pendingCap : 4096;
+        while (newCap < spectator->pendingLen + msg->len)
+            newCap *= 2;
+        char *grown = realloc(spectator->pending, newCap);
+        if (grown == NULL) {
+            spectator->needsKeyframe = true;
+            return;
+        }
+        spectator->pending = grown;
+        spectator->pendingCap = newCap;
+    }
+    memcpy(spectator->pending + spectator->pendingLen, msg->data, msg->len);
+    spectator->pendingLen += msg->len;
+
+    SpectatorMessageHeader *header = (SpectatorMessageHeader *)msg->data;
+    if (header->type == SPECTATOR_KEYFRAME)
+        spectator->needsKeyframe = false;
+}
+
+// Envía sin bloquear lo que el socket acepte; devuelve false si el cliente se cerró
+bool flushSpectator(Spectator *spectator)
+{
+    if (spectator->fd == -1)
+        return false;
+
+    size_t sent = spectator->sentOfHead;
+    while (sent < spectator->pendingLen) {
+        ssize_t n = send(spectator->fd, spectator->pending + sent, spectator->pendingLen - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            close(spectator->fd);
+            spectator->fd = -1;
+            return false;
+        }
+        sent += (size_t)n;
+    }
+
+    // Se compacta el buffer dejando al frente el primer mensaje incompleto
+    size_t offset = 0;
+    while (offset < spectator->pendingLen) {
+        SpectatorMessageHeader head;
+        memcpy(&head, spectator->pending + offset, sizeof(head));
+        if (offset + head.length > sent)
+            break;
+        offset += head.length;
+    }
+    memmove(spectator->pending, spectator->pending + offset, spectator->pendingLen - offset);
+    spectator->pendingLen -= offset;
+    spectator->sentOfHead = sent - offset;
+    return true;
+}
+
+void removeClosedSpectators(void)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < spectatorsCount; i++) {
+        if (spectators[i].fd == -1) {
+            free(spectators[i].pending);
+            continue;
+        }
+        spectators[kept++] = spectators[i];
+    }
+    spectatorsCount = kept;
+}
+
+bool anyPendingOutput(void)
+{
+    for (size_t i = 0; i < spectatorsCount; i++) {
+        if (spectators[i].pendingLen > spectators[i].sentOfHead)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+#ifndef ESPECTADOR_H_
+#define ESPECTADOR_H_
+#include <stdint.h>
+#include "estructuras.h"
+
+// Protocolo del servidor de espectadores (socket Unix local, orden de bytes del host).
+//
+// Cada mensaje empieza con un SpectatorMessageHeader y sigue con:
+//   1. un Player por cada bit encendido de playersMask, en orden de índice;
+//   2. si type == SPECTATOR_KEYFRAME: cellsCount (= width*height) int32_t con la grilla completa;
+//      si type == SPECTATOR_DELTA: cellsCount SpectatorCell con las celdas que cambiaron.
+//
+// Un suscriptor recibe siempre un keyframe al conectarse y otro cada vez que el
+// servidor tuvo que descartar datos suyos por no leer a tiempo; entre keyframes
+// aplica los deltas sobre su copia.
+
+#define SPECTATOR_DEFAULT_PATH "/tmp/game_spectators.sock"
+
+#define SPECTATOR_KEYFRAME 1
+#define SPECTATOR_DELTA 2
+
+typedef struct
+{
+    uint32_t length;      // bytes totales del mensaje, encabezado incluido
+    uint32_t round;       // ronda del master al copiar el estado (0 antes de la primera); puede
+                          // saltar rondas que el master juntó en un aviso y repetirse en el cuadro final
+    uint8_t type;
+    uint8_t gameOver;
+    uint16_t playersMask; // jugadores incluidos a continuación del encabezado
+    uint32_t cellsCount;
+    uint16_t width;
+    uint16_t height;
+} SpectatorMessageHeader;
+
+typedef struct
+{
+    uint32_t index;       // y * width + x
+    int32_t value;
+} SpectatorCell;
+
+#endif
@@ -0,0 +1,218 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// Caso fijo del servidor de espectadores: hace de master (reutiliza las funciones
+// de master.c con su main renombrado) y juega rondas guionadas contra ./espectador.
+// Un suscriptor conectado desde el principio aplica keyframe y deltas; otro que se
+// conecta antes de la última ronda recibe el keyframe final. Las dos copias y la
+// memoria compartida tienen que coincidir, y las rondas de los encabezados tienen
+// que ser las publicadas por el master.
+#define main masterMain
+#include "master.c"
+#undef main
+#include "espectador.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define CHECK_W 10
+#define CHECK_H 12
+#define CHECK_PLAYERS 2
+#define CHECK_ROUNDS 20
+#define CHECK_WAIT_S 2
+
+typedef struct
+{
+    Player players[MAX_PLAYERS];
+    int grid[CHECK_W * CHECK_H];
+    unsigned int messages;
+    uint32_t firstRound, lastRound;
+    bool consecutive; // cada mensaje trae la ronda siguiente a la del anterior
+    bool gameOver;
+} SubscriberCopy;
+
+static bool waitFrame(Semaphores *semaphores)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += CHECK_WAIT_S;
+    sem_post(&semaphores->pendingView);
+    while (sem_timedwait(&semaphores->viewEndedPrinting, &deadline) == -1)
+    {
+        if (errno != EINTR)
+            return false;
+    }
+    return true;
+}
+
+static int connectSubscriber(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    // El espectador crea el socket al arrancar: se reintenta hasta CHECK_WAIT_S
+    for (int attempt = 0; attempt < CHECK_WAIT_S * 1000; attempt++)
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1)
+            return -1;
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        {
+            struct timeval timeout = {CHECK_WAIT_S, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            return fd;
+        }
+        close(fd);
+        usleep(1000);
+    }
+    return -1;
+}
+
+static bool readExact(int fd, void *data, size_t len)
+{
+    char *out = data;
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, out, len, 0);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        out += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Lee mensajes hasta que el espectador cierra la conexión
+static bool applyMessages(int fd, SubscriberCopy *copy)
+{
+    SpectatorMessageHeader header;
+    while (readExact(fd, &header, sizeof(header)))
+    {
+        if (header.width != CHECK_W || header.height != CHECK_H || header.cellsCount > CHECK_W * CHECK_H)
+            return false;
+        if (copy->messages == 0 && header.type != SPECTATOR_KEYFRAME)
+            return false;
+
+        for (unsigned int i = 0; i < MAX_PLAYERS; i++)
+        {
+            if ((header.playersMask & (1u << i)) && !readExact(fd, &copy->players[i], sizeof(Player)))
+                return false;
+        }
+        if (header.type == SPECTATOR_KEYFRAME)
+        {
+            if (!readExact(fd, copy->grid, header.cellsCount * sizeof(int32_t)))
+                return false;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < header.cellsCount; i++)
+            {
+                SpectatorCell cell;
+                if (!readExact(fd, &cell, sizeof(cell)) || cell.index >= CHECK_W * CHECK_H)
+                    return false;
+                copy->grid[cell.index] = cell.value;
+            }
+        }
+
+        if (copy->messages == 0)
+            copy->firstRound = header.round;
+        else if (header.round != copy->lastRound + 1)
+            copy->consecutive = false;
+        copy->lastRound = header.round;
+        copy->gameOver = header.gameOver;
+        copy->messages++;
+    }
+    return copy->messages > 0;
+}
+
+static bool sameState(const SubscriberCopy *copy, const GameState *gameState)
+{
+    return memcmp(copy->players, gameState->players, CHECK_PLAYERS * sizeof(Player)) == 0 &&
+           memcmp(copy->grid, gameState->grid, sizeof(copy->grid)) == 0;
+}
+
+int main(void)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/espectador_check_%d.sock", (int)getpid());
+
+    srand(1);
+    GameState *gameState = createSharedMemoryState(CHECK_W, CHECK_H, CHECK_PLAYERS, PAGING_DEFAULT);
+    Semaphores *semaphores = createSharedMemorySemaphores(CHECK_PLAYERS);
+    HintIndex *hints = createSharedMemoryHints();
+    g_hints = hints;
+
+    pid_t spectatorPid = fork();
+    if (spectatorPid == -1)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (spectatorPid == 0)
+    {
+        char width[8], height[8];
+        snprintf(width, sizeof(width), "%d", CHECK_W);
+        snprintf(height, sizeof(height), "%d", CHECK_H);
+        execl("./espectador", "espectador", width, height, path, (char *)NULL);
+        perror("execl ./espectador");
+        _exit(1);
+    }
+
+    int early = connectSubscriber(path);
+    int late = -1;
+    bool played = early != -1 && waitFrame(semaphores);
+
+    // Cada jugador baja una fila por ronda alternándose: P1 por la columna 0 y P2 por la última
+    for (unsigned int round = 1; played && round <= CHECK_ROUNDS; round++)
+    {
+        if (round == CHECK_ROUNDS)
+        {
+            // El espectador acepta conexiones al terminar cada ronda y, sin aviso pendiente,
+            // cada 50 ms: se conecta cuando ya despachó la anterior y se lo deja aceptar
+            // antes de la última para que su primer keyframe sea el estado final
+            usleep(200 * 1000);
+            late = connectSubscriber(path);
+            usleep(200 * 1000);
+        }
+
+        masterEnters(semaphores);
+        Player *player = &gameState->players[round % CHECK_PLAYERS];
+        player->y++;
+        int *cell = &gameState->grid[player->y * CHECK_W + player->x];
+        player->score += *cell;
+        player->valid++;
+        *cell = -(int)(round % CHECK_PLAYERS);
+        hints->round = round;
+        gameState->gameOver = round == CHECK_ROUNDS;
+        masterLeaves(semaphores);
+
+        played = waitFrame(semaphores);
+    }
+
+    SubscriberCopy earlyCopy = {.consecutive = true}, lateCopy = {.consecutive = true};
+    bool earlyRead = played && applyMessages(early, &earlyCopy);
+    bool lateRead = played && late != -1 && applyMessages(late, &lateCopy);
+
+    int status = 1;
+    if (waitpid(spectatorPid, &status, 0) == -1)
+        status = 1;
+
+    bool ok = earlyRead && lateRead && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+              earlyCopy.firstRound == 0 && earlyCopy.consecutive && earlyCopy.lastRound == CHECK_ROUNDS &&
+              earlyCopy.gameOver && lateCopy.messages == 1 && lateCopy.lastRound == CHECK_ROUNDS &&
+              sameState(&earlyCopy, gameState) && sameState(&lateCopy, gameState);
+    printf("Espectador: %u mensajes, rondas %u..%u, copia por deltas %s al keyframe final: %s\n",
+           earlyCopy.messages, earlyCopy.firstRound, earlyCopy.lastRound,
+           earlyRead && lateRead && memcmp(&earlyCopy.grid, &lateCopy.grid, sizeof(earlyCopy.grid)) == 0 ? "igual" : "distinta",
+           ok ? "ok" : "FALLA");
+
+    if (early != -1)
+        close(early);
+    if (late != -1)
+        close(late);
+    cleanup_resources(CHECK_W, CHECK_H, CHECK_PLAYERS, gameState, semaphores);
+    return ok ? 0 : 1;
+}
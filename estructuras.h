@@ -14,6 +14,26 @@
 #include <unistd.h>
 #define MAX_PLAYERS 9
 
+// Variantes especializadas (make master_64x64_9 player_64x64_9): con FIXED_WIDTH,
+// FIXED_HEIGHT y FIXED_PLAYERS el ancho, el alto y la cantidad de jugadores son
+// constantes de compilación, así el compilador pliega la aritmética de índices y
+// desenrolla los recorridos. Sin ellas se usa el valor recibido en ejecución.
+#ifdef FIXED_WIDTH
+#define GRID_WIDTH(w) ((unsigned int)FIXED_WIDTH)
+#else
+#define GRID_WIDTH(w) (w)
+#endif
+#ifdef FIXED_HEIGHT
+#define GRID_HEIGHT(h) ((unsigned int)FIXED_HEIGHT)
+#else
+#define GRID_HEIGHT(h) (h)
+#endif
+#ifdef FIXED_PLAYERS
+#define GRID_PLAYERS(n) ((unsigned int)FIXED_PLAYERS)
+#else
+#define GRID_PLAYERS(n) (n)
+#endif
+
 typedef struct
 {
     char playerName[16];
@@ -35,6 +55,50 @@ typedef struct
     int grid[]; // grilla almacenada en memoria compartida en formato arreglo width*height
 } GameState;
 
+// Registro de cambios publicado por el master en /game_feed (opcional: los
+// clientes que no lo encuentran siguen leyendo la grilla completa). Cada
+// movimiento válido agrega la celda capturada y quién la capturó, de modo que
+// un jugador puede mantener su copia del tablero en O(cambios). Se escribe
+// con el lock de escritura del master y se lee con el de lectores.
+#define FEED_CAPACITY 16384 // potencia de 2
+
+typedef struct
+{
+    unsigned int round;     // ronda del master en la que se aplicó el movimiento
+    unsigned short x, y;    // celda capturada (nueva posición del jugador)
+    unsigned char player;
+} FeedEntry;
+
+typedef struct
+{
+    pid_t master;            // creador; permite descartar un registro viejo de otra partida
+    unsigned long long head; // total de entradas publicadas; la i-ésima vive en entries[i % FEED_CAPACITY]
+    unsigned int round;      // última ronda publicada
+    FeedEntry entries[FEED_CAPACITY];
+} ChangeFeed;
+
+// Pistas publicadas por el master en /game_hints (opcionales, como el registro
+// de cambios): para cada jugador, las direcciones libres alrededor de su cabeza y
+// la de mayor valor. Se recalculan en la misma sección crítica que aplica los
+// movimientos, así que leídas con el lock de lectores coinciden con la grilla y
+// un bot simple decide en O(1) sin recorrer vecinas.
+#define HINT_NONE 0xFF // sin vecinas libres
+
+typedef struct
+{
+    unsigned char freeMask;  // bit m encendido si la dirección m (0 arriba, sentido horario) está libre
+    unsigned char freeCount; // cantidad de bits de freeMask
+    unsigned char bestMove;  // dirección libre de mayor valor (la menor a igualdad) o HINT_NONE
+    unsigned char bestValue; // valor de esa celda, 0 si no hay
+} PlayerHint;
+
+typedef struct
+{
+    pid_t master;            // creador; permite descartar pistas viejas de otra partida
+    unsigned int round;      // ronda del master en la que se calcularon
+    PlayerHint players[MAX_PLAYERS];
+} HintIndex;
+
 typedef struct
 {
     sem_t pendingView;
@@ -44,6 +108,7 @@ typedef struct
     sem_t mutexPlayerAccess;
     unsigned int playersReadingState;
     sem_t playerCanMove[9];
+    bool viewRecords; // la vista graba cada ronda: el master la espera en lugar de juntar rondas
 } Semaphores;
 
 
@@ -56,7 +121,12 @@ static inline GameState * connectToSharedMemoryState(unsigned int width, unsigne
 
     size_t map_size = sizeof(GameState) + (size_t)width * height * sizeof(int);
 
-    GameState *gameState = mmap(NULL, map_size, PROT_READ , MAP_SHARED, gameStateSmFd, 0);
+    // Con -H populate|thp el master pasa GAME_PAGING y los clientes también cargan las
+    // tablas de páginas de una vez (la grilla ya está escrita) en lugar de un fallo por
+    // página al primer recorrido; sin él se mapea como siempre
+    const char *paging = getenv("GAME_PAGING");
+    int flags = MAP_SHARED | (paging != NULL && strcmp(paging, "default") != 0 ? MAP_POPULATE : 0);
+    GameState *gameState = mmap(NULL, map_size, PROT_READ, flags, gameStateSmFd, 0);
     if (gameState == MAP_FAILED) {
         fprintf(stderr, "Error al mapear la memoria compartida: errno=%d (%s)\n", errno, strerror(errno));
         close(gameStateSmFd);
@@ -88,5 +158,75 @@ static inline Semaphores * connectToSharedMemorySemaphores(void) {
 }
 
 
+// Lock de lectores y escritor sobre el estado del juego. El master escribe con
+// masterEnters/masterLeaves: mutexMasterAccess hace de torniquete para que los
+// jugadores que llegan después no lo posterguen indefinidamente.
+static inline void masterEnters(Semaphores *semaphores) {
+    sem_wait(&semaphores->mutexMasterAccess);
+    sem_wait(&semaphores->mutexGameState);
+    sem_post(&semaphores->mutexMasterAccess);
+}
+
+static inline void masterLeaves(Semaphores *semaphores) {
+    sem_post(&semaphores->mutexGameState);
+}
+
+// Lado de los jugadores (lectores)
+static inline void acquireGameStatePlayerLock(Semaphores *semaphore) {
+    sem_wait(&semaphore->mutexMasterAccess);  // Espera si el master esta escribiendo
+    sem_post(&semaphore->mutexMasterAccess);  // De lo contrario, libera el control del master inmediatamente
+
+    sem_wait(&semaphore->mutexPlayerAccess);
+    if (semaphore->playersReadingState++ == 0) {
+        sem_wait(&semaphore->mutexGameState); // el primer lector toma el mutex
+    }
+    sem_post(&semaphore->mutexPlayerAccess);
+}
+
+static inline void releaseGameStatePlayerLock(Semaphores *semaphore) {
+    sem_wait(&semaphore->mutexPlayerAccess);
+    if (--semaphore->playersReadingState == 0) {
+        sem_post(&semaphore->mutexGameState); // el último lector en salir libera el mutex
+    }
+    sem_post(&semaphore->mutexPlayerAccess);
+}
+
+static inline ChangeFeed * connectToSharedMemoryFeed(void) {
+    int feedSmFd = shm_open("/game_feed", O_RDONLY, 0666);
+    if (feedSmFd == -1) {
+        return NULL; // master sin registro de cambios
+    }
+
+    ChangeFeed *feed = mmap(NULL, sizeof(ChangeFeed), PROT_READ, MAP_SHARED, feedSmFd, 0);
+    if (feedSmFd > STDERR_FILENO) close(feedSmFd);
+
+    if (feed == MAP_FAILED) {
+        return NULL;
+    }
+    if (feed->master != getppid()) {
+        munmap(feed, sizeof(ChangeFeed));
+        return NULL;
+    }
+    return feed;
+}
+
+static inline HintIndex * connectToSharedMemoryHints(void) {
+    int hintsSmFd = shm_open("/game_hints", O_RDONLY, 0666);
+    if (hintsSmFd == -1) {
+        return NULL; // master sin pistas
+    }
+
+    HintIndex *hints = mmap(NULL, sizeof(HintIndex), PROT_READ, MAP_SHARED, hintsSmFd, 0);
+    if (hintsSmFd > STDERR_FILENO) close(hintsSmFd);
+
+    if (hints == MAP_FAILED) {
+        return NULL;
+    }
+    if (hints->master != getppid()) {
+        munmap(hints, sizeof(HintIndex));
+        return NULL;
+    }
+    return hints;
+}
 
 #endif
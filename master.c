@@ -1,5 +1,6 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE // sched_setaffinity y CPU_SET
 #include "estructuras.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -17,37 +18,215 @@
 #include <errno.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include "bitboard.h"
+
+// Desplazamiento (dx, dy) de cada movimiento: 0 arriba y en sentido horario. El mismo
+// orden sirve de anillo de vecinas en ringComponents.
+static const int moveDx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int moveDy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+// Paginado de /game_state (-H): con populate el mapeo se crea ya cargado
+// (MAP_POPULATE); con thp además se pide madvise(MADV_HUGEPAGE) antes de tocarlo,
+// que solo surte efecto si /sys/kernel/mm/transparent_hugepage/shmem_enabled lo
+// permite. hugetlbfs no es posible sin cambiar cómo se conectan los clientes,
+// porque shm_open siempre abre en /dev/shm.
+typedef enum
+{
+    PAGING_DEFAULT,
+    PAGING_POPULATE,
+    PAGING_THP
+} SharedPaging;
+
+static const char *pagingNames[] = {"default", "populate", "thp"};
 
-GameState *createSharedMemoryState(unsigned short width, unsigned short height, unsigned int numPlayers);
+GameState *createSharedMemoryState(unsigned short width, unsigned short height, unsigned int numPlayers, SharedPaging paging);
+unsigned long hugeMappedKb(const void *address);
 Semaphores *createSharedMemorySemaphores(unsigned int numPlayers);
+ChangeFeed *createSharedMemoryFeed(void);
+void publishCapture(ChangeFeed *feed, unsigned int round, unsigned int player, unsigned short x, unsigned short y);
+HintIndex *createSharedMemoryHints(void);
+void scanNeighbours(const GameState *gameState, unsigned int player, PlayerHint *hint);
 void cleanup_resources(unsigned int width, unsigned int height, unsigned int numPlayers, GameState *gameState, Semaphores *semaphores);
 void signal_handler(int sig);
-void masterEnters(Semaphores *semaphores);
-void masterLeaves(Semaphores *semaphores);
+
+// Histograma de latencia de respuesta de un jugador: tiempo entre habilitarlo
+// (sem_post de playerCanMove) y leer su movimiento del pipe
+#define LATENCY_BUCKETS 10
+static const unsigned int latencyLimitsMs[LATENCY_BUCKETS - 1] = {1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+typedef struct
+{
+    unsigned long buckets[LATENCY_BUCKETS]; // el último cuenta las respuestas de 500 ms o más
+    unsigned long samples;
+    unsigned long long totalMicros;
+    unsigned long long maxMicros;
+    unsigned int forfeits; // turnos perdidos por superar el plazo por movimiento
+    unsigned long long heldMicros; // tiempo entre su respuesta y el siguiente turno
+} LatencyHistogram;
+
+long long elapsedMicros(const struct timespec *from, const struct timespec *to);
+
+// Detección de partida decidida: las celdas libres solo se capturan, así que las
+// regiones solo se parten. La relación "dos jugadores activos comparten región"
+// solo puede cambiar si una captura parte o vacía una región, si la cabeza que se
+// mueve tocaba más de una región, si la celda capturada era la entrada de otra
+// cabeza vecina a una región, o si un jugador se bloquea. Las tres primeras se
+// detectan mirando las 8 vecinas de las celdas involucradas y las cabezas
+// adyacentes a la captura, y recién entonces se recalculan las regiones con la
+// inundación de bitboard.h.
+typedef enum
+{
+    DECIDED_PLAY, // se sigue jugando normalmente (por defecto)
+    DECIDED_END,  // se termina la partida con los puntajes actuales
+    DECIDED_FAST  // el master completa el resto de cada jugador sin handshakes
+} DecidedMode;
+
+typedef struct
+{
+    Bitboard freeCells, heads, region, scratch;
+    bool dirty;
+    unsigned int activePlayers; // jugadores activos en el último análisis
+    unsigned int analyses;
+} RegionTracker;
+
+bool initRegions(RegionTracker *tracker, const GameState *gameState);
+void freeRegions(RegionTracker *tracker);
+int ringComponents(const GameState *gameState, int x, int y, int freeX, int freeY);
+void regionsCapture(RegionTracker *tracker, const GameState *gameState, int fromX, int fromY, int toX, int toY);
+bool regionsDecided(RegionTracker *tracker, const GameState *gameState);
+unsigned int fastForward(RegionTracker *tracker, GameState *gameState, ChangeFeed *feed, unsigned int round);
+void recordLatency(LatencyHistogram *histogram, long long micros);
+void printLatency(FILE *out, const LatencyHistogram *histogram);
+double jainIndex(const double *values, unsigned int count);
+
+// Reporte para procesar en lote (--report json|csv [--report-file ruta]): la
+// configuración de la partida, totales y una entrada por jugador
+typedef enum
+{
+    REPORT_NONE,
+    REPORT_JSON,
+    REPORT_CSV
+} ReportFormat;
+
+typedef struct
+{
+    unsigned int width, height, delay, timeout, seed, moveTimeout, maxLead;
+    const char *view;
+    const char *decidedMode;
+    unsigned int numPlayers;
+    unsigned int rounds;
+    double seconds;
+    unsigned long turns, validMoves;
+    const char *paging;
+    double startupMs;
+    unsigned long hugeKb;
+    long masterMinorFaults, masterMajorFaults;
+    unsigned long lockAcquisitions;
+} ReportGame;
+
+typedef struct
+{
+    const char *binary;
+    const Player *state;
+    unsigned int forfeits;
+    unsigned int blockedRound; // 0 si terminó sin bloquearse
+    int exitCode;              // -1 si no terminó con exit
+    int signal;                // 0 si no lo terminó una señal
+    long minorFaults, majorFaults;
+} ReportPlayer;
+
+void writeJsonString(FILE *out, const char *text);
+void writeCsvString(FILE *out, const char *text);
+bool writeReport(ReportFormat format, const char *path, const ReportGame *game, const ReportPlayer *players);
+
+// Ubicación de procesos: con -a se fija la CPU del master, de la vista y de cada
+// jugador (en ese orden, repitiendo la lista si es más corta). "auto" ordena las
+// CPUs permitidas con un hilo por núcleo físico primero y los hermanos SMT al
+// final, así los primeros procesos no comparten núcleo. Los hijos se fijan
+// después del fork y antes del execve; la política del master (-f/-n) se aplica
+// una vez creados los hijos para que no la hereden.
+typedef struct
+{
+    bool enabled;
+    bool automatic;
+    int cpus[CPU_SETSIZE];
+    int count;
+} Placement;
+
+// Duración de cada ronda con movimientos (desde que select() despierta hasta
+// terminar de aplicarlos) y espera por el lock de escritura, en potencias de 2 de us
+#define ROUND_BUCKETS 32
+
+typedef struct
+{
+    unsigned long buckets[ROUND_BUCKETS];
+    unsigned long rounds;
+    unsigned long long totalMicros, maxMicros;
+    unsigned long lockAcquisitions;
+    unsigned long long lockWaitMicros, lockWaitMaxMicros;
+} RoundStats;
+
+bool parsePlacement(const char *spec, Placement *placement);
+int placementCpu(const Placement *placement, unsigned int slot);
+void pinToCpu(int cpu, const char *who);
+void applyMasterPolicy(int fifoPriority, bool niceSet, int niceValue);
+void recordRound(RoundStats *stats, long long micros);
+unsigned long long roundPercentile(const RoundStats *stats, double fraction);
+void timedMasterEnters(Semaphores *semaphores, RoundStats *stats);
+void notifyView(Semaphores *semaphores, bool *viewBusy, unsigned long *viewFrames);
 
 // Variables globales para cleanup en señales
 static GameState *g_gameState = NULL;
 static Semaphores *g_semaphores = NULL;
+static ChangeFeed *g_feed = NULL;
+static HintIndex *g_hints = NULL;
 static unsigned int g_width = 0, g_height = 0, g_numPlayers = 0;
 
-void sleep_ms(int delay)
+// Aviso a la vista sin esperarla: el master no se frena al ritmo de la pantalla
+// (-d lo aplica la vista entre cuadros). Si la vista todavía está con el cuadro
+// anterior no se la vuelve a avisar y esas rondas salen juntas en el próximo.
+// Una vista que graba (viewRecords) no puede perder rondas: a esa se la espera.
+void notifyView(Semaphores *semaphores, bool *viewBusy, unsigned long *viewFrames)
 {
-    struct timespec ts;
-    ts.tv_sec = delay / 1000;               // parte entera en segundos
-    ts.tv_nsec = (delay % 1000) * 1000000L; // resto en nanosegundos
-    nanosleep(&ts, NULL);
+    if (semaphores->viewRecords)
+    {
+        sem_post(&semaphores->pendingView);
+        sem_wait(&semaphores->viewEndedPrinting);
+        (*viewFrames)++;
+        return;
+    }
+    if (*viewBusy && sem_trywait(&semaphores->viewEndedPrinting) == 0)
+        *viewBusy = false;
+    if (!*viewBusy)
+    {
+        sem_post(&semaphores->pendingView);
+        *viewBusy = true;
+        (*viewFrames)++;
+    }
 }
 
 int main(int argc, char *argv[])
 {
-    unsigned int width = 10, height = 10, delay = 200, timeout = 10, seed = time(NULL), numPlayers = 0;
+    unsigned int width = GRID_WIDTH(10), height = GRID_HEIGHT(10), delay = 200, timeout = 10, seed = time(NULL), numPlayers = 0;
+    unsigned int moveTimeout = 0; // plazo por movimiento en ms, 0 sin plazo
+    DecidedMode decidedMode = DECIDED_PLAY;
+    unsigned int maxLead = 1; // turnos de ventaja sobre el jugador activo más atrasado: 1 rondas estrictas, 0 sin límite
+    Placement placement = {0};
+    int fifoPriority = 0, niceValue = 0;
+    bool niceSet = false;
+    ReportFormat reportFormat = REPORT_NONE;
+    const char *reportPath = NULL; // NULL: stdout
+    SharedPaging paging = PAGING_DEFAULT;
     char *view = NULL;
     char *players[MAX_PLAYERS] = {0};
 
     // Validación parámetros mínimos
     if (argc < 3)
     {
-        fprintf(stderr, "Uso: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-v view] -p player1 [player2 ...]\n", argv[0]);
+        fprintf(stderr, "Uso: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-m move_timeout_ms] [-e end|fast] [-r async|lockstep] [-k max_lead] [-a auto|cpus] [-f fifo_prio] [-n nice] [--report json|csv] [--report-file path] [-H default|populate|thp] [-v view] -p player1 [player2 ...]\n", argv[0]);
+        fprintf(stderr, "  -r/-k: por defecto lockstep (rondas estrictas); -r async quita el límite y -k N deja adelantarse hasta N turnos\n");
         exit(1);
     }
 
@@ -78,6 +257,95 @@ int main(int argc, char *argv[])
             timeout = atoi(argv[i + 1]);
             i++;
         }
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc)
+        {
+            moveTimeout = atoi(argv[i + 1]);
+            i++;
+        }
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc)
+        {
+            if (!strcmp(argv[i + 1], "end"))
+                decidedMode = DECIDED_END;
+            else if (!strcmp(argv[i + 1], "fast"))
+                decidedMode = DECIDED_FAST;
+            else
+            {
+                fprintf(stderr, "Modo de fin anticipado desconocido '%s' (end|fast)\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+        {
+            if (!strcmp(argv[i + 1], "lockstep"))
+                maxLead = 1;
+            else if (!strcmp(argv[i + 1], "async"))
+                maxLead = 0;
+            else
+            {
+                fprintf(stderr, "Planificador desconocido '%s' (async|lockstep)\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (!strcmp(argv[i], "-k") && i + 1 < argc)
+        {
+            maxLead = atoi(argv[i + 1]);
+            i++;
+        }
+        else if (!strcmp(argv[i], "-a") && i + 1 < argc)
+        {
+            if (!parsePlacement(argv[i + 1], &placement))
+            {
+                fprintf(stderr, "Lista de CPUs inválida '%s' (auto o p.ej. 0,2,4-7)\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+        {
+            fifoPriority = atoi(argv[i + 1]);
+            i++;
+        }
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+        {
+            niceValue = atoi(argv[i + 1]);
+            niceSet = true;
+            i++;
+        }
+        else if (!strcmp(argv[i], "--report") && i + 1 < argc)
+        {
+            if (!strcmp(argv[i + 1], "json"))
+                reportFormat = REPORT_JSON;
+            else if (!strcmp(argv[i + 1], "csv"))
+                reportFormat = REPORT_CSV;
+            else
+            {
+                fprintf(stderr, "Formato de reporte desconocido '%s' (json|csv)\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
+        else if (!strcmp(argv[i], "--report-file") && i + 1 < argc)
+        {
+            reportPath = strcmp(argv[i + 1], "-") ? argv[i + 1] : NULL;
+            i++;
+        }
+        else if (!strcmp(argv[i], "-H") && i + 1 < argc)
+        {
+            if (!strcmp(argv[i + 1], "default"))
+                paging = PAGING_DEFAULT;
+            else if (!strcmp(argv[i + 1], "populate"))
+                paging = PAGING_POPULATE;
+            else if (!strcmp(argv[i + 1], "thp"))
+                paging = PAGING_THP;
+            else
+            {
+                fprintf(stderr, "Modo de paginado desconocido '%s' (default|populate|thp)\n", argv[i + 1]);
+                exit(1);
+            }
+            i++;
+        }
         else if (!strcmp(argv[i], "-s") && i + 1 < argc)
         {
             seed = atoi(argv[i + 1]);
@@ -115,6 +383,15 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+#if defined(FIXED_WIDTH) || defined(FIXED_HEIGHT) || defined(FIXED_PLAYERS)
+    if (width != GRID_WIDTH(width) || height != GRID_HEIGHT(height) || numPlayers != GRID_PLAYERS(numPlayers))
+    {
+        fprintf(stderr, "Este master está especializado para %ux%u con %u jugadores\n", GRID_WIDTH(width),
+                GRID_HEIGHT(height), GRID_PLAYERS(numPlayers));
+        exit(1);
+    }
+#endif
+
     // Establecimiento de la semilla para números aleatorios
     srand(seed);
 
@@ -123,10 +400,35 @@ int main(int argc, char *argv[])
     signal(SIGTERM, signal_handler);
 
     // Creación de las memorias compartidas
-    GameState *gameState = createSharedMemoryState(width, height, numPlayers);
+    struct timespec startupBegin, startupEnd;
+    clock_gettime(CLOCK_MONOTONIC, &startupBegin);
+    GameState *gameState = createSharedMemoryState(width, height, numPlayers, paging);
+    clock_gettime(CLOCK_MONOTONIC, &startupEnd);
+    double startupMs = elapsedMicros(&startupBegin, &startupEnd) / 1000.0;
+    unsigned long hugeKb = hugeMappedKb(gameState);
+    if (paging == PAGING_THP && hugeKb == 0)
+    {
+        fprintf(stderr, "Aviso: /game_state no quedó en páginas grandes (revisar transparent_hugepage/shmem_enabled)\n");
+    }
     Semaphores *semaphores = createSharedMemorySemaphores(numPlayers);
+    ChangeFeed *feed = createSharedMemoryFeed();
+    HintIndex *hints = createSharedMemoryHints();
+    for (unsigned int i = 0; i < numPlayers; i++)
+    {
+        scanNeighbours(gameState, i, &hints->players[i]);
+    }
+
+    RegionTracker regions;
+    if (decidedMode != DECIDED_PLAY && !initRegions(&regions, gameState))
+    {
+        fprintf(stderr, "Sin memoria para el análisis de regiones\n");
+        exit(1);
+    }
+    unsigned int decidedRound = 0, fastForwarded = 0;
 
     // Configuración de variables globales para cleanup en señales
+    g_feed = feed;
+    g_hints = hints;
     g_gameState = gameState;
     g_semaphores = semaphores;
     g_width = width;
@@ -159,8 +461,17 @@ int main(int argc, char *argv[])
 
         if (vista_pid == 0)
         {
+            if (placement.enabled)
+                pinToCpu(placementCpu(&placement, 1), "vista");
+            // El ritmo de cuadros y el paginado (-H) viajan por el entorno porque las
+            // vistas reciben solo ancho y alto
+            char termEnv[256], delayEnv[32], pagingEnv[32];
+            const char *term = getenv("TERM");
+            snprintf(termEnv, sizeof(termEnv), "TERM=%s", term != NULL ? term : "");
+            snprintf(delayEnv, sizeof(delayEnv), "GAME_DELAY_MS=%u", delay);
+            snprintf(pagingEnv, sizeof(pagingEnv), "GAME_PAGING=%s", pagingNames[paging]);
             char *vista_argv[] = {view, wbuf, hbuf, NULL};
-            char *envp[] = {getenv("TERM"), NULL};
+            char *envp[] = {termEnv, delayEnv, pagingEnv, NULL};
             execve(view, vista_argv, envp);
             perror("execve vista");
             exit(1);
@@ -200,11 +511,16 @@ int main(int argc, char *argv[])
                 exit(1);
             }
             close(pipePlayerToMaster[i][1]); // Cerramos descriptor original tras dup2
+            close(pipePlayerToMaster[i][0]); // El extremo de lectura es solo del master
             char wbuf[16], hbuf[16];
             snprintf(wbuf, sizeof wbuf, "%u", width);
             snprintf(hbuf, sizeof hbuf, "%u", height);
+            if (placement.enabled)
+                pinToCpu(placementCpu(&placement, (view != NULL ? 2 : 1) + i), players[i]);
+            char pagingEnv[32];
+            snprintf(pagingEnv, sizeof(pagingEnv), "GAME_PAGING=%s", pagingNames[paging]);
             char *player_argv[] = {players[i], wbuf, hbuf, NULL};
-            char *envp[] = {NULL};
+            char *envp[] = {pagingEnv, NULL};
             execve(players[i], player_argv, envp);
             fprintf(stderr, "execve player '%s': %s\n", players[i], strerror(errno));
             exit(1);
@@ -216,16 +532,54 @@ int main(int argc, char *argv[])
         close(pipePlayerToMaster[i][1]);
     }
 
-    // Impresión del estado inicial (en caso de tener vista)
+    // Ubicación y política del master, ya sin hijos por crear que las hereden
+    if (placement.enabled)
+    {
+        pinToCpu(placementCpu(&placement, 0), "master");
+    }
+    applyMasterPolicy(fifoPriority, niceSet, niceValue);
+
+    // Impresión del estado inicial (en caso de tener vista). Este cuadro se espera
+    // siempre: así la vista ya avisó si graba antes de que empiecen las rondas.
+    bool viewBusy = false;
+    unsigned long viewFrames = 0;
     if (view != NULL)
     {
         sem_post(&semaphores->pendingView);
         sem_wait(&semaphores->viewEndedPrinting);
-        sleep_ms(delay);
+        viewFrames++;
     }
 
     // Lógica principal del juego con select()
     time_t lastValidMove = time(NULL);
+    unsigned int round = 0;
+
+    // Estado del turno de cada jugador: solo se lo habilita de nuevo cuando respondió,
+    // así playerCanMove no acumula permisos y cada respuesta corresponde a un turno.
+    // Si vence el plazo el turno se pierde y la respuesta que llegue tarde se descarta.
+    //
+    // Planificación: por defecto lockstep (ventaja 1), es decir rondas estrictas. Con
+    // -r async cada jugador se rehabilita apenas se aplica su movimiento, y -k acota
+    // la ventaja en turnos respondidos sobre el jugador activo más atrasado para que
+    // uno rápido no deje sin celdas a uno lento. Los turnos perdidos
+    // por plazo cuentan como respondidos. El orden de lectura rota en cada pasada
+    // para que los empates sobre una misma celda no favorezcan siempre al índice menor.
+    bool awaiting[numPlayers], lateReply[numPlayers];
+    struct timespec grantedAt[numPlayers], repliedAt[numPlayers], blockedAt[numPlayers];
+    unsigned long answered[numPlayers];
+    unsigned int blockedRound[numPlayers];
+    bool blockedSeen[numPlayers];
+    LatencyHistogram latency[numPlayers];
+    memset(awaiting, 0, sizeof(awaiting));
+    memset(lateReply, 0, sizeof(lateReply));
+    memset(answered, 0, sizeof(answered));
+    memset(blockedSeen, 0, sizeof(blockedSeen));
+    memset(blockedRound, 0, sizeof(blockedRound));
+    memset(latency, 0, sizeof(latency));
+    RoundStats roundStats;
+    memset(&roundStats, 0, sizeof(roundStats));
+    struct timespec gameStart, gameEnd;
+    clock_gettime(CLOCK_MONOTONIC, &gameStart);
 
     while (1)
     {
@@ -251,11 +605,36 @@ int main(int argc, char *argv[])
             break; // Si todos estan bloqueados, termina el juego
         }
 
-        // Habilitación a todos los jugadores activos para que puedan moverse
-        for (unsigned int i = 0; i < numPlayers; i++)
+        // Habilitación de los jugadores activos sin turno pendiente y dentro de la ventaja permitida
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        unsigned long minAnswered = (unsigned long)-1;
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
         {
-            if (!gameState->players[i].blocked)
+            if (gameState->players[i].blocked)
+            {
+                if (!blockedSeen[i])
+                {
+                    blockedSeen[i] = true;
+                    blockedAt[i] = now;
+                }
+            }
+            else if (answered[i] < minAnswered)
             {
+                minAnswered = answered[i];
+            }
+        }
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
+        {
+            if (!gameState->players[i].blocked && !awaiting[i] &&
+                (maxLead == 0 || answered[i] < minAnswered + maxLead))
+            {
+                if (answered[i] > 0)
+                {
+                    latency[i].heldMicros += (unsigned long long)elapsedMicros(&repliedAt[i], &now);
+                }
+                awaiting[i] = true;
+                grantedAt[i] = now;
                 sem_post(&semaphores->playerCanMove[i]);
             }
         }
@@ -265,9 +644,11 @@ int main(int argc, char *argv[])
         FD_ZERO(&readfds);
         int maxfd = -1;
 
-        for (unsigned int i = 0; i < numPlayers; i++)
+        // Solo se escucha a quienes tienen un turno pendiente: lo que un jugador escriba
+        // de más queda en el pipe y se toma como respuesta de sus turnos siguientes
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
         {
-            if (!gameState->players[i].blocked)
+            if (!gameState->players[i].blocked && awaiting[i])
             {
                 FD_SET(pipePlayerToMaster[i][0], &readfds);
                 if (pipePlayerToMaster[i][0] > maxfd)
@@ -283,10 +664,24 @@ int main(int argc, char *argv[])
             continue;
         }
 
-        // Uso de select() para esperar movimientos de cualquier jugador
+        // Uso de select() para esperar movimientos de cualquier jugador, como mucho
+        // 1 segundo o hasta el vencimiento del plazo más próximo
+        long long waitMicros = 1000000;
+        if (moveTimeout > 0)
+        {
+            for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
+            {
+                if (!gameState->players[i].blocked && awaiting[i])
+                {
+                    long long left = (long long)moveTimeout * 1000 - elapsedMicros(&grantedAt[i], &now);
+                    if (left < waitMicros)
+                        waitMicros = left < 0 ? 0 : left;
+                }
+            }
+        }
         struct timeval selectTimeout;
-        selectTimeout.tv_sec = 1; // 1 segundo de timeout para el select
-        selectTimeout.tv_usec = 0;
+        selectTimeout.tv_sec = waitMicros / 1000000;
+        selectTimeout.tv_usec = waitMicros % 1000000;
 
         int selectResult = select(maxfd + 1, &readfds, NULL, NULL, &selectTimeout);
 
@@ -297,15 +692,24 @@ int main(int argc, char *argv[])
         }
         else if (selectResult == 0)
         {
-            // Timeout del select, continua el bucle
-            continue;
+            FD_ZERO(&readfds); // Timeout del select: solo se revisan los plazos
         }
 
-        // Procesamiento de movimientos de todos los jugadores que tienen datos listos
+        // Primero se vacían los pipes listos sin tomar el lock, en el orden rotativo
+        // de la ronda; después el lote entero se valida y aplica en una sola sección
+        // crítica, junto con los plazos vencidos y la verificación de bloqueos
         bool anyValidMove = false;
+        round++;
+        clock_gettime(CLOCK_MONOTONIC, &now);
 
-        for (unsigned int i = 0; i < numPlayers; i++)
+        unsigned int batchPlayer[numPlayers], batchSize = 0;
+        unsigned char batchMove[numPlayers];
+        bool closedPipe[numPlayers];
+        memset(closedPipe, 0, sizeof(closedPipe));
+
+        for (unsigned int k = 0; k < GRID_PLAYERS(numPlayers); k++)
         {
+            unsigned int i = (round + k) % GRID_PLAYERS(numPlayers);
             if (!gameState->players[i].blocked && FD_ISSET(pipePlayerToMaster[i][0], &readfds))
             {
                 unsigned char movement;
@@ -317,92 +721,117 @@ int main(int argc, char *argv[])
                 }
                 else if (bytesRead == 0)
                 {
-                    gameState->players[i].blocked = true;
+                    closedPipe[i] = true;
                     continue;
                 }
 
-                // Procesamiento del movimiento
-                masterEnters(semaphores);
-
-                int currentX = gameState->players[i].x;
-                int currentY = gameState->players[i].y;
-                int newX = currentX, newY = currentY;
-
-                switch (movement)
+                awaiting[i] = false;
+                repliedAt[i] = now;
+                if (lateReply[i])
                 {
-                case 0:
-                    newY--;
-                    break; // arriba
-                case 1:
-                    newX++;
-                    newY--;
-                    break; // arriba-derecha
-                case 2:
-                    newX++;
-                    break; // derecha
-                case 3:
-                    newX++;
-                    newY++;
-                    break; // abajo-derecha
-                case 4:
-                    newY++;
-                    break; // abajo
-                case 5:
-                    newX--;
-                    newY++;
-                    break; // abajo-izquierda
-                case 6:
-                    newX--;
-                    break; // izquierda
-                case 7:
-                    newX--;
-                    newY--;
-                    break; // arriba-izquierda
-                default:   /* movimiento inválido */
-                    break;
+                    // Respuesta a un turno ya perdido por plazo: se descarta
+                    lateReply[i] = false;
+                    continue;
                 }
+                answered[i]++;
+                recordLatency(&latency[i], elapsedMicros(&grantedAt[i], &now));
+                batchPlayer[batchSize] = i;
+                batchMove[batchSize] = movement;
+                batchSize++;
+            }
+        }
+
+        timedMasterEnters(semaphores, &roundStats);
+
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
+        {
+            if (closedPipe[i])
+                gameState->players[i].blocked = true;
+        }
+
+        for (unsigned int b = 0; b < batchSize; b++)
+        {
+            unsigned int i = batchPlayer[b];
+            int currentX = gameState->players[i].x;
+            int currentY = gameState->players[i].y;
+            int newX = currentX, newY = currentY;
 
-                if (newX >= 0 && newY >= 0 &&
-                    (unsigned int)newX < width && (unsigned int)newY < height &&
-                    gameState->grid[(unsigned int)newY * width + (unsigned int)newX] > 0)
+            switch (batchMove[b])
+            {
+            case 0:
+                newY--;
+                break; // arriba
+            case 1:
+                newX++;
+                newY--;
+                break; // arriba-derecha
+            case 2:
+                newX++;
+                break; // derecha
+            case 3:
+                newX++;
+                newY++;
+                break; // abajo-derecha
+            case 4:
+                newY++;
+                break; // abajo
+            case 5:
+                newX--;
+                newY++;
+                break; // abajo-izquierda
+            case 6:
+                newX--;
+                break; // izquierda
+            case 7:
+                newX--;
+                newY--;
+                break; // arriba-izquierda
+            default:   /* movimiento inválido */
+                break;
+            }
+
+            if (newX >= 0 && newY >= 0 &&
+                (unsigned int)newX < GRID_WIDTH(width) && (unsigned int)newY < GRID_HEIGHT(height) &&
+                gameState->grid[(unsigned int)newY * GRID_WIDTH(width) + (unsigned int)newX] > 0)
+            {
+                // Movimiento válido
+                gameState->players[i].score +=
+                    gameState->grid[(unsigned int)newY * GRID_WIDTH(width) + (unsigned int)newX];
+                gameState->players[i].valid++;
+                // marca celda visitada por el jugador con -(index+1)
+                gameState->grid[(unsigned int)newY * GRID_WIDTH(width) + (unsigned int)newX] = -(int)i;
+                gameState->players[i].x = (unsigned short)newX;
+                gameState->players[i].y = (unsigned short)newY;
+                publishCapture(feed, round, i, (unsigned short)newX, (unsigned short)newY);
+                if (decidedMode != DECIDED_PLAY)
                 {
-                    // Movimiento válido
-                    gameState->players[i].score +=
-                        gameState->grid[(unsigned int)newY * width + (unsigned int)newX];
-                    gameState->players[i].valid++;
-                    // marca celda visitada por el jugador con -(index+1)
-                    gameState->grid[(unsigned int)newY * width + (unsigned int)newX] = -(int)i;
-                    gameState->players[i].x = (unsigned short)newX;
-                    gameState->players[i].y = (unsigned short)newY;
-
-                    anyValidMove = true;
-
-                    // Verificación de si el jugador quedó bloqueado (sin movimientos válidos)
-                    bool hasValidMoves = false;
-                    for (int dy = -1; dy <= 1 && !hasValidMoves; dy++)
-                    {
-                        for (int dx = -1; dx <= 1 && !hasValidMoves; dx++)
-                        {
-                            if (dx == 0 && dy == 0)
-                                continue;
-                            int checkX = newX + dx;
-                            int checkY = newY + dy;
-                            if (checkX >= 0 && checkY >= 0 &&
-                                (unsigned int)checkX < width && (unsigned int)checkY < height &&
-                                gameState->grid[(unsigned int)checkY * width + (unsigned int)checkX] > 0)
-                            {
-                                hasValidMoves = true;
-                            }
-                        }
-                    }
-                    gameState->players[i].blocked = !hasValidMoves;
+                    regionsCapture(&regions, gameState, currentX, currentY, newX, newY);
                 }
-                else
+
+                anyValidMove = true;
+            }
+            else
+            {
+                // Movimiento inválido (puede ser porque otro jugador del lote ya tomó esa celda)
+                gameState->players[i].invalid++;
+            }
+        }
+
+        // Turnos vencidos: cuentan como movimiento inválido y el plazo vuelve a correr
+        // sin habilitar de nuevo al jugador hasta que conteste el turno perdido
+        if (moveTimeout > 0)
+        {
+            for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
+            {
+                if (!gameState->players[i].blocked && awaiting[i] &&
+                    elapsedMicros(&grantedAt[i], &now) >= (long long)moveTimeout * 1000)
                 {
-                    // Movimiento inválido (puede ser porque otro jugador ya tomó esa celda)
                     gameState->players[i].invalid++;
+                    latency[i].forfeits++;
+                    answered[i]++;
+                    lateReply[i] = true;
+                    grantedAt[i] = now;
                 }
-                masterLeaves(semaphores);
             }
         }
 
@@ -412,60 +841,77 @@ int main(int argc, char *argv[])
             lastValidMove = time(NULL);
         }
 
-        // Verificación de bloqueo o no de todos los jugadores después de procesar movimientos
-        masterEnters(semaphores);
-        for (unsigned int i = 0; i < numPlayers; i++)
+        // Pistas y verificación de bloqueo de todos los jugadores después de aplicar el
+        // lote: el mismo recorrido de vecinas sirve para las dos cosas
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
         {
-            if (!gameState->players[i].blocked)
+            scanNeighbours(gameState, i, &hints->players[i]);
+            if (hints->players[i].freeCount == 0)
             {
-                bool hasValidMoves = false;
-                int currentX = gameState->players[i].x;
-                int currentY = gameState->players[i].y;
-
-                for (int dy = -1; dy <= 1 && !hasValidMoves; dy++)
-                {
-                    for (int dx = -1; dx <= 1 && !hasValidMoves; dx++)
-                    {
-                        if (dx == 0 && dy == 0)
-                            continue;
-                        int checkX = currentX + dx;
-                        int checkY = currentY + dy;
-                        if (checkX >= 0 && checkY >= 0 &&
-                            (unsigned int)checkX < width && (unsigned int)checkY < height &&
-                            gameState->grid[(unsigned int)checkY * width + (unsigned int)checkX] > 0)
-                        {
-                            hasValidMoves = true;
-                        }
-                    }
-                }
+                gameState->players[i].blocked = true;
+            }
+        }
+        hints->round = round;
 
-                if (!hasValidMoves)
+        // Fin anticipado si ya ningún par de jugadores activos comparte región
+        bool decided = decidedMode != DECIDED_PLAY && regionsDecided(&regions, gameState);
+        if (decided)
+        {
+            decidedRound = round;
+            if (decidedMode == DECIDED_FAST)
+            {
+                fastForwarded = fastForward(&regions, gameState, feed, round);
+                for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
                 {
-                    gameState->players[i].blocked = true;
+                    scanNeighbours(gameState, i, &hints->players[i]);
                 }
             }
         }
         masterLeaves(semaphores);
 
+        for (unsigned int i = 0; i < GRID_PLAYERS(numPlayers); i++)
+        {
+            if (gameState->players[i].blocked && blockedRound[i] == 0)
+                blockedRound[i] = round;
+        }
+
+        if (selectResult > 0)
+        {
+            struct timespec roundEnd;
+            clock_gettime(CLOCK_MONOTONIC, &roundEnd);
+            recordRound(&roundStats, elapsedMicros(&now, &roundEnd));
+        }
+
+        if (decided)
+        {
+            break;
+        }
+
         // Notificación a la vista (si hay una y hubo algún movimiento válido)
         if (view != NULL && anyValidMove)
         {
-            sem_post(&semaphores->pendingView);
-            sem_wait(&semaphores->viewEndedPrinting);
-            sleep_ms(delay);
+            notifyView(semaphores, &viewBusy, &viewFrames);
         }
     }
 
     // Marcado del fin del juego
+    // Antes se recoge el aviso pendiente, si lo hay: la vista sale al ver gameOver,
+    // así que solo el último cuadro puede mostrarlo
+    clock_gettime(CLOCK_MONOTONIC, &gameEnd);
+    if (view != NULL && viewBusy)
+    {
+        sem_wait(&semaphores->viewEndedPrinting);
+    }
     masterEnters(semaphores);
     gameState->gameOver = true;
     masterLeaves(semaphores);
 
-    // Notificación a la vista del final (si existe)
+    // Notificación a la vista del final (si existe): este cuadro sí se espera
     if (view != NULL)
     {
         sem_post(&semaphores->pendingView);
         sem_wait(&semaphores->viewEndedPrinting);
+        viewFrames++;
     }
 
     // Habilitación a todos los jugadores para que puedan terminar
@@ -475,57 +921,162 @@ int main(int argc, char *argv[])
     }
 
     // Una vez que terminan los procesos hijos, se imprimen los resultados finales
-    printf("\n=== RESULTADOS FINALES ===\n");
+    // Con --report a stdout el resumen legible va a stderr para no mezclarse
+    FILE *summary = reportFormat != REPORT_NONE && reportPath == NULL ? stderr : stdout;
+    fprintf(summary, "\n=== RESULTADOS FINALES ===\n");
+
+    if (decidedMode != DECIDED_PLAY)
+    {
+        if (decidedRound > 0)
+            fprintf(summary, "Regiones separadas en la ronda %u (%u análisis): %s, %u movimientos completados por el master\n",
+                   decidedRound, regions.analyses, decidedMode == DECIDED_END ? "partida terminada" : "resto adelantado",
+                   fastForwarded);
+        freeRegions(&regions);
+    }
+
+    // Rendimiento y equidad del planificador: movimientos por segundo de cada jugador
+    // mientras estuvo activo, resumidos con el índice de Jain (1 = reparto parejo)
+    double gameSeconds = elapsedMicros(&gameStart, &gameEnd) / 1e6;
+    double rates[numPlayers];
+    unsigned long totalAnswered = 0;
+    for (unsigned int i = 0; i < numPlayers; i++)
+    {
+        double activeSeconds = elapsedMicros(&gameStart, blockedSeen[i] ? &blockedAt[i] : &gameEnd) / 1e6;
+        rates[i] = activeSeconds > 0 ? answered[i] / activeSeconds : 0;
+        totalAnswered += answered[i];
+    }
+    fprintf(summary, "Planificador %s: %lu turnos en %.2f s (%.0f turnos/s), índice de Jain %.3f\n",
+           maxLead == 0 ? "asíncrono" : maxLead == 1 ? "lockstep" : "asíncrono con ventaja acotada",
+           totalAnswered, gameSeconds, gameSeconds > 0 ? totalAnswered / gameSeconds : 0.0,
+           jainIndex(rates, numPlayers));
+
+    // Ubicación usada y latencia de ronda, para comparar configuraciones
+    fprintf(summary, "Ubicación: ");
+    if (placement.enabled)
+    {
+        fprintf(summary, "%smaster cpu %d", placement.automatic ? "auto, " : "", placementCpu(&placement, 0));
+        if (view != NULL)
+            fprintf(summary, ", vista cpu %d", placementCpu(&placement, 1));
+        fprintf(summary, ", jugadores cpu");
+        for (unsigned int i = 0; i < numPlayers; i++)
+            fprintf(summary, " %d", placementCpu(&placement, (view != NULL ? 2 : 1) + i));
+    }
+    else
+    {
+        fprintf(summary, "sin fijar");
+    }
+    struct sched_param schedParam;
+    bool fifo = (sched_getscheduler(0) & ~SCHED_RESET_ON_FORK) == SCHED_FIFO && sched_getparam(0, &schedParam) == 0;
+    fprintf(summary, "; master %s", fifo ? "SCHED_FIFO" : "SCHED_OTHER");
+    if (fifo)
+        fprintf(summary, " prioridad %d", schedParam.sched_priority);
+    fprintf(summary, " nice %d\n", getpriority(PRIO_PROCESS, 0));
+    fprintf(summary, "Rondas: %lu, latencia media %.1f us, p50 <%llu us, p99 <%llu us, máxima %llu us; "
+           "lock de escritura %lu veces (%.2f por ronda), espera media %.1f us, máxima %llu us\n",
+           roundStats.rounds, roundStats.rounds ? (double)roundStats.totalMicros / roundStats.rounds : 0.0,
+           roundPercentile(&roundStats, 0.5), roundPercentile(&roundStats, 0.99), roundStats.maxMicros,
+           roundStats.lockAcquisitions, round ? (double)roundStats.lockAcquisitions / round : 0.0,
+           roundStats.lockAcquisitions ? (double)roundStats.lockWaitMicros / roundStats.lockAcquisitions : 0.0,
+           roundStats.lockWaitMaxMicros);
+
+    ReportPlayer reportPlayers[numPlayers];
+    for (unsigned int i = 0; i < numPlayers; i++)
+    {
+        reportPlayers[i].binary = players[i];
+        reportPlayers[i].state = &gameState->players[i];
+        reportPlayers[i].forfeits = latency[i].forfeits;
+        reportPlayers[i].blockedRound = blockedRound[i];
+        reportPlayers[i].exitCode = -1;
+        reportPlayers[i].signal = 0;
+        reportPlayers[i].minorFaults = reportPlayers[i].majorFaults = -1;
+    }
+
+    // Se cierran los pipes antes de esperar a los jugadores: uno que siga escribiendo
+    // con el pipe lleno recibe EPIPE en lugar de quedar bloqueado para siempre
+    for (unsigned int i = 0; i < numPlayers; i++)
+    {
+        if (pipePlayerToMaster[i][0] != -1)
+        {
+            close(pipePlayerToMaster[i][0]);
+        }
+    }
 
     for (unsigned int i = 0; i < numPlayers; i++)
     {
         if (player_pids[i] != -1)
         {
             int status;
-            pid_t result = waitpid(player_pids[i], &status, 0);
+            struct rusage usage;
+            pid_t result = wait4(player_pids[i], &status, 0, &usage);
             if (result == player_pids[i])
             {
+                reportPlayers[i].exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+                reportPlayers[i].signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+                reportPlayers[i].minorFaults = usage.ru_minflt;
+                reportPlayers[i].majorFaults = usage.ru_majflt;
                 if (WIFEXITED(status))
                 {
-                    printf("Jugador %d (%s): Puntaje %u, Validos %u, Invalidos %u, Salió con código %d\n",
+                    fprintf(summary, "Jugador %d (%s): Puntaje %u, Validos %u, Invalidos %u, Salió con código %d\n",
                            i + 1, gameState->players[i].playerName,
                            gameState->players[i].score, gameState->players[i].valid,
                            gameState->players[i].invalid, WEXITSTATUS(status));
+                    printLatency(summary, &latency[i]);
+                    fprintf(summary, "    Fallos de página: %ld menores, %ld mayores\n", usage.ru_minflt, usage.ru_majflt);
                 }
                 else if (WIFSIGNALED(status))
                 {
-                    printf("Jugador %d (%s): Puntaje %u, Validos %u, Invalidos %u, Terminado por señal %d\n",
+                    fprintf(summary, "Jugador %d (%s): Puntaje %u, Validos %u, Invalidos %u, Terminado por señal %d\n",
                            i + 1, gameState->players[i].playerName,
                            gameState->players[i].score, gameState->players[i].valid,
                            gameState->players[i].invalid, WTERMSIG(status));
+                    printLatency(summary, &latency[i]);
+                    fprintf(summary, "    Fallos de página: %ld menores, %ld mayores\n", usage.ru_minflt, usage.ru_majflt);
                 }
             }
         }
-        if (pipePlayerToMaster[i][0] != -1)
-        {
-            close(pipePlayerToMaster[i][0]);
-        }
     }
 
     if (vista_pid != -1)
     {
         int status;
-        pid_t result = waitpid(vista_pid, &status, 0);
+        struct rusage usage;
+        pid_t result = wait4(vista_pid, &status, 0, &usage);
         if (result == vista_pid)
         {
             if (WIFEXITED(status))
             {
-                printf("Vista: Salió con código %d\n", WEXITSTATUS(status));
+                fprintf(summary, "Vista: Salió con código %d\n", WEXITSTATUS(status));
             }
             else if (WIFSIGNALED(status))
             {
-                printf("Vista: Terminada por señal %d\n", WTERMSIG(status));
+                fprintf(summary, "Vista: Terminada por señal %d\n", WTERMSIG(status));
             }
+            fprintf(summary, "    Fallos de página: %ld menores, %ld mayores\n", usage.ru_minflt, usage.ru_majflt);
+            fprintf(summary, "    Cuadros: %lu para %u rondas (cada %u ms)\n", viewFrames, round, delay);
         }
 
     }
 
-    printf("========================\n");
+    struct rusage masterUsage;
+    getrusage(RUSAGE_SELF, &masterUsage);
+    fprintf(summary, "Memoria compartida: paginado %s, %zu KB, %lu KB en páginas grandes, creación %.2f ms; "
+                     "fallos de página del master: %ld menores, %ld mayores\n",
+            pagingNames[paging], (sizeof(GameState) + (size_t)width * height * sizeof(int) + 1023) / 1024, hugeKb,
+            startupMs, masterUsage.ru_minflt, masterUsage.ru_majflt);
+    fprintf(summary, "========================\n");
+
+    if (reportFormat != REPORT_NONE)
+    {
+        ReportGame reportGame = {width, height, delay, timeout, seed, moveTimeout, maxLead, view,
+                                 decidedMode == DECIDED_PLAY ? "play" : decidedMode == DECIDED_END ? "end" : "fast",
+                                 numPlayers, round, gameSeconds, totalAnswered, 0,
+                                 pagingNames[paging], startupMs, hugeKb, masterUsage.ru_minflt, masterUsage.ru_majflt,
+                                 roundStats.lockAcquisitions};
+        for (unsigned int i = 0; i < numPlayers; i++)
+            reportGame.validMoves += gameState->players[i].valid;
+        if (!writeReport(reportFormat, reportPath, &reportGame, reportPlayers))
+            fprintf(stderr, "No se pudo escribir el reporte en '%s': %s\n", reportPath ? reportPath : "stdout", strerror(errno));
+    }
 
     // Limpieza de memoria compartida y semáforos
     cleanup_resources(width, height, numPlayers, gameState, semaphores);
@@ -533,7 +1084,522 @@ int main(int argc, char *argv[])
     return 0;
 }
 
-GameState *createSharedMemoryState(unsigned short width, unsigned short height, unsigned int numPlayers)
+long long elapsedMicros(const struct timespec *from, const struct timespec *to)
+{
+    return (long long)(to->tv_sec - from->tv_sec) * 1000000 + (to->tv_nsec - from->tv_nsec) / 1000;
+}
+
+void recordLatency(LatencyHistogram *histogram, long long micros)
+{
+    if (micros < 0)
+        micros = 0;
+    unsigned int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && (unsigned long long)micros >= latencyLimitsMs[bucket] * 1000ULL)
+        bucket++;
+    histogram->buckets[bucket]++;
+    histogram->samples++;
+    histogram->totalMicros += (unsigned long long)micros;
+    if ((unsigned long long)micros > histogram->maxMicros)
+        histogram->maxMicros = (unsigned long long)micros;
+}
+
+void printLatency(FILE *out, const LatencyHistogram *histogram)
+{
+    fprintf(out, "    Latencia: %lu respuestas, media %.2f ms, máxima %.2f ms, turnos perdidos por plazo %u, retenido %.1f ms\n",
+           histogram->samples,
+           histogram->samples ? histogram->totalMicros / 1000.0 / histogram->samples : 0.0,
+           histogram->maxMicros / 1000.0, histogram->forfeits, histogram->heldMicros / 1000.0);
+    if (histogram->samples == 0)
+        return;
+    fprintf(out, "   ");
+    for (unsigned int b = 0; b < LATENCY_BUCKETS; b++)
+    {
+        if (b < LATENCY_BUCKETS - 1)
+            fprintf(out, " <%ums:%lu", latencyLimitsMs[b], histogram->buckets[b]);
+        else
+            fprintf(out, " >=%ums:%lu", latencyLimitsMs[b - 1], histogram->buckets[b]);
+    }
+    fprintf(out, "\n");
+}
+
+bool initRegions(RegionTracker *tracker, const GameState *gameState)
+{
+    unsigned int W = GRID_WIDTH(gameState->width), H = GRID_HEIGHT(gameState->height);
+    if (!bbInit(&tracker->freeCells, W, H) || !bbInit(&tracker->heads, W, H) ||
+        !bbInit(&tracker->region, W, H) || !bbInit(&tracker->scratch, W, H))
+        return false;
+
+    for (unsigned int y = 0; y < H; y++)
+        for (unsigned int x = 0; x < W; x++)
+            if (gameState->grid[y * W + x] > 0)
+                bbSet(&tracker->freeCells, x, y);
+    tracker->dirty = false;
+    tracker->activePlayers = gameState->playersNumber;
+    tracker->analyses = 0;
+    return true;
+}
+
+void freeRegions(RegionTracker *tracker)
+{
+    bbFree(&tracker->freeCells);
+    bbFree(&tracker->heads);
+    bbFree(&tracker->region);
+    bbFree(&tracker->scratch);
+}
+
+// Cantidad de grupos de celdas libres (vecindad de 8) entre las 8 vecinas de (x, y),
+// contando (freeX, freeY) como libre. Si las vecinas libres forman un solo grupo,
+// todas pertenecen a la misma región del tablero.
+int ringComponents(const GameState *gameState, int x, int y, int freeX, int freeY)
+{
+    bool isFree[8];
+    for (int k = 0; k < 8; k++)
+    {
+        int nx = x + moveDx[k], ny = y + moveDy[k];
+        isFree[k] = (nx == freeX && ny == freeY) ||
+                    (nx >= 0 && ny >= 0 && nx < (int)GRID_WIDTH(gameState->width) && ny < (int)GRID_HEIGHT(gameState->height) &&
+                     gameState->grid[ny * (int)GRID_WIDTH(gameState->width) + nx] > 0);
+    }
+
+    // Vecinas consecutivas del anillo siempre se tocan; las ortogonales (índices
+    // pares) además tocan a la ortogonal siguiente en diagonal.
+    int label[8], components = 0;
+    for (int k = 0; k < 8; k++)
+        label[k] = -1;
+    for (int k = 0; k < 8; k++)
+    {
+        if (!isFree[k] || label[k] != -1)
+            continue;
+        int stack[8], top = 0;
+        stack[top++] = k;
+        label[k] = components;
+        while (top > 0)
+        {
+            int c = stack[--top];
+            int next[4] = {(c + 1) % 8, (c + 7) % 8, c % 2 == 0 ? (c + 2) % 8 : -1, c % 2 == 0 ? (c + 6) % 8 : -1};
+            for (int n = 0; n < 4; n++)
+            {
+                if (next[n] >= 0 && isFree[next[n]] && label[next[n]] == -1)
+                {
+                    label[next[n]] = components;
+                    stack[top++] = next[n];
+                }
+            }
+        }
+        components++;
+    }
+    return components;
+}
+
+// Se llama después de aplicar la captura de (toX, toY) por la cabeza que estaba en (fromX, fromY)
+void regionsCapture(RegionTracker *tracker, const GameState *gameState, int fromX, int fromY, int toX, int toY)
+{
+    bbReset(&tracker->freeCells, (unsigned int)toX, (unsigned int)toY);
+    if (tracker->dirty)
+        return;
+    int around = ringComponents(gameState, toX, toY, -1, -1);
+    if (around != 1 || ringComponents(gameState, fromX, fromY, toX, toY) > 1)
+    {
+        tracker->dirty = true;
+        return;
+    }
+    // Otra cabeza activa pegada a la celda capturada pudo perder por ella su única
+    // entrada a la región del que se movió, aunque las vecinas sigan en un grupo
+    for (unsigned int j = 0; j < GRID_PLAYERS(gameState->playersNumber); j++)
+    {
+        const Player *other = &gameState->players[j];
+        if (other->blocked || (other->x == toX && other->y == toY))
+            continue;
+        if (abs(other->x - toX) <= 1 && abs(other->y - toY) <= 1)
+        {
+            tracker->dirty = true;
+            return;
+        }
+    }
+}
+
+// Se llama con el lock de escritura tomado. true si cada jugador activo tiene su
+// región para él solo.
+bool regionsDecided(RegionTracker *tracker, const GameState *gameState)
+{
+    unsigned int active = 0;
+    for (unsigned int i = 0; i < GRID_PLAYERS(gameState->playersNumber); i++)
+        if (!gameState->players[i].blocked)
+            active++;
+    if (active != tracker->activePlayers)
+    {
+        tracker->activePlayers = active;
+        tracker->dirty = true;
+    }
+    if (!tracker->dirty)
+        return false;
+    tracker->dirty = false;
+    tracker->analyses++;
+
+    for (unsigned int i = 0; i < GRID_PLAYERS(gameState->playersNumber); i++)
+    {
+        if (gameState->players[i].blocked)
+            continue;
+        bbClear(&tracker->heads);
+        for (unsigned int j = 0; j < GRID_PLAYERS(gameState->playersNumber); j++)
+            if (j != i && !gameState->players[j].blocked)
+                bbSet(&tracker->heads, gameState->players[j].x, gameState->players[j].y);
+        bbReachableFrom(&tracker->region, &tracker->freeCells, gameState->players[i].x, gameState->players[i].y);
+        if (!bbRegionIsolated(&tracker->region, &tracker->heads, &tracker->scratch))
+            return false;
+    }
+    return true;
+}
+
+// Completa el resto de la partida de cada jugador activo dentro de su región con un
+// recorrido de Warnsdorff (primero la vecina con menos salidas, a igualdad la de mayor
+// valor). Las regiones son disjuntas, así que el orden entre jugadores no importa.
+// Se llama con el lock de escritura tomado; devuelve la cantidad de movimientos aplicados.
+unsigned int fastForward(RegionTracker *tracker, GameState *gameState, ChangeFeed *feed, unsigned int round)
+{
+    int W = GRID_WIDTH(gameState->width), H = GRID_HEIGHT(gameState->height);
+    unsigned int applied = 0;
+
+    for (unsigned int i = 0; i < GRID_PLAYERS(gameState->playersNumber); i++)
+    {
+        Player *player = &gameState->players[i];
+        while (!player->blocked)
+        {
+            int bestX = -1, bestY = -1, bestExits = 9, bestValue = 0;
+            for (int m = 0; m < 8; m++)
+            {
+                int nx = player->x + moveDx[m], ny = player->y + moveDy[m];
+                if (nx < 0 || ny < 0 || nx >= W || ny >= H || gameState->grid[ny * W + nx] <= 0)
+                    continue;
+                int exits = 0;
+                for (int k = 0; k < 8; k++)
+                {
+                    int ex = nx + moveDx[k], ey = ny + moveDy[k];
+                    if (ex >= 0 && ey >= 0 && ex < W && ey < H && gameState->grid[ey * W + ex] > 0)
+                        exits++;
+                }
+                int value = gameState->grid[ny * W + nx];
+                if (exits < bestExits || (exits == bestExits && value > bestValue))
+                {
+                    bestX = nx;
+                    bestY = ny;
+                    bestExits = exits;
+                    bestValue = value;
+                }
+            }
+            if (bestX == -1)
+            {
+                player->blocked = true;
+                break;
+            }
+            player->score += gameState->grid[bestY * W + bestX];
+            player->valid++;
+            gameState->grid[bestY * W + bestX] = -(int)i;
+            player->x = (unsigned short)bestX;
+            player->y = (unsigned short)bestY;
+            publishCapture(feed, round, i, (unsigned short)bestX, (unsigned short)bestY);
+            bbReset(&tracker->freeCells, (unsigned int)bestX, (unsigned int)bestY);
+            applied++;
+        }
+    }
+    return applied;
+}
+
+double jainIndex(const double *values, unsigned int count)
+{
+    double sum = 0, squares = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        sum += values[i];
+        squares += values[i] * values[i];
+    }
+    return squares > 0 ? sum * sum / (count * squares) : 1.0;
+}
+
+void writeJsonString(FILE *out, const char *text)
+{
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)(text != NULL ? text : ""); *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fprintf(out, "\\%c", *c);
+        else if (*c < 0x20)
+            fprintf(out, "\\u%04x", *c);
+        else
+            fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+void writeCsvString(FILE *out, const char *text)
+{
+    fputc('"', out);
+    for (const char *c = text != NULL ? text : ""; *c; c++)
+    {
+        if (*c == '"')
+            fputc('"', out);
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+bool writeReport(ReportFormat format, const char *path, const ReportGame *game, const ReportPlayer *players)
+{
+    FILE *out = path != NULL ? fopen(path, "w") : stdout;
+    if (out == NULL)
+        return false;
+
+    const char *scheduler = game->maxLead == 0 ? "async" : game->maxLead == 1 ? "lockstep" : "bounded";
+    double movesPerSecond = game->seconds > 0 ? game->validMoves / game->seconds : 0.0;
+
+    if (format == REPORT_JSON)
+    {
+        fprintf(out, "{\n  \"config\": {\"width\": %u, \"height\": %u, \"delay_ms\": %u, \"timeout_s\": %u, "
+                     "\"seed\": %u, \"move_timeout_ms\": %u, \"scheduler\": \"%s\", \"max_lead\": %u, "
+                     "\"decided\": \"%s\", \"view\": ",
+                game->width, game->height, game->delay, game->timeout, game->seed, game->moveTimeout, scheduler,
+                game->maxLead, game->decidedMode);
+        if (game->view != NULL)
+            writeJsonString(out, game->view);
+        else
+            fprintf(out, "null");
+        fprintf(out, ", \"paging\": \"%s\"},\n  \"duration_s\": %.6f, \"rounds\": %u, \"turns\": %lu, \"valid_moves\": %lu, "
+                     "\"moves_per_s\": %.2f,\n  \"startup_ms\": %.3f, \"huge_kb\": %lu, \"master_minor_faults\": %ld, "
+                     "\"master_major_faults\": %ld, \"lock_acquisitions\": %lu,\n  \"players\": [\n",
+                game->paging, game->seconds, game->rounds, game->turns, game->validMoves, movesPerSecond,
+                game->startupMs, game->hugeKb, game->masterMinorFaults, game->masterMajorFaults, game->lockAcquisitions);
+        for (unsigned int i = 0; i < game->numPlayers; i++)
+        {
+            const ReportPlayer *player = &players[i];
+            fprintf(out, "    {\"index\": %u, \"name\": ", i + 1);
+            writeJsonString(out, player->state->playerName);
+            fprintf(out, ", \"binary\": ");
+            writeJsonString(out, player->binary);
+            fprintf(out, ", \"score\": %u, \"valid\": %u, \"invalid\": %u, \"forfeits\": %u, \"blocked_round\": ",
+                    player->state->score, player->state->valid, player->state->invalid, player->forfeits);
+            if (player->blockedRound > 0)
+                fprintf(out, "%u", player->blockedRound);
+            else
+                fprintf(out, "null");
+            fprintf(out, ", \"exit_code\": ");
+            if (player->exitCode >= 0)
+                fprintf(out, "%d", player->exitCode);
+            else
+                fprintf(out, "null");
+            fprintf(out, ", \"signal\": ");
+            if (player->signal > 0)
+                fprintf(out, "%d", player->signal);
+            else
+                fprintf(out, "null");
+            fprintf(out, ", \"minor_faults\": %ld, \"major_faults\": %ld}%s\n", player->minorFaults,
+                    player->majorFaults, i + 1 < game->numPlayers ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+    else
+    {
+        // Una fila por jugador con la configuración repetida, para concatenar partidas
+        fprintf(out, "seed,width,height,delay_ms,timeout_s,move_timeout_ms,scheduler,max_lead,decided,view,paging,"
+                     "duration_s,rounds,turns,valid_moves,moves_per_s,startup_ms,huge_kb,master_minor_faults,master_major_faults,lock_acquisitions,"
+                     "player,name,binary,score,valid,invalid,forfeits,blocked_round,exit_code,signal,minor_faults,major_faults\n");
+        for (unsigned int i = 0; i < game->numPlayers; i++)
+        {
+            const ReportPlayer *player = &players[i];
+            fprintf(out, "%u,%u,%u,%u,%u,%u,%s,%u,%s,", game->seed, game->width, game->height, game->delay,
+                    game->timeout, game->moveTimeout, scheduler, game->maxLead, game->decidedMode);
+            writeCsvString(out, game->view);
+            fprintf(out, ",%s,%.6f,%u,%lu,%lu,%.2f,%.3f,%lu,%ld,%ld,%lu,%u,", game->paging, game->seconds, game->rounds,
+                    game->turns, game->validMoves, movesPerSecond, game->startupMs, game->hugeKb,
+                    game->masterMinorFaults, game->masterMajorFaults, game->lockAcquisitions, i + 1);
+            writeCsvString(out, player->state->playerName);
+            fputc(',', out);
+            writeCsvString(out, player->binary);
+            fprintf(out, ",%u,%u,%u,%u,", player->state->score, player->state->valid, player->state->invalid,
+                    player->forfeits);
+            if (player->blockedRound > 0)
+                fprintf(out, "%u", player->blockedRound);
+            fputc(',', out);
+            if (player->exitCode >= 0)
+                fprintf(out, "%d", player->exitCode);
+            fputc(',', out);
+            if (player->signal > 0)
+                fprintf(out, "%d", player->signal);
+            fprintf(out, ",%ld,%ld\n", player->minorFaults, player->majorFaults);
+        }
+    }
+
+    if (path != NULL)
+        return fclose(out) == 0;
+    return fflush(out) == 0 && !ferror(out);
+}
+
+// KB del mapeo que empieza en address respaldados por páginas grandes, según /proc/self/smaps
+unsigned long hugeMappedKb(const void *address)
+{
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (smaps == NULL)
+        return 0;
+    char line[256];
+    bool inMapping = false;
+    unsigned long total = 0;
+    while (fgets(line, sizeof(line), smaps) != NULL)
+    {
+        unsigned long start, end, kb;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2)
+        {
+            inMapping = start == (unsigned long)address;
+        }
+        else if (inMapping && (sscanf(line, "ShmemPmdMapped: %lu kB", &kb) == 1 ||
+                               sscanf(line, "FilePmdMapped: %lu kB", &kb) == 1))
+        {
+            total += kb;
+        }
+    }
+    fclose(smaps);
+    return total;
+}
+
+bool parsePlacement(const char *spec, Placement *placement)
+{
+    placement->enabled = true;
+    placement->count = 0;
+    placement->automatic = !strcmp(spec, "auto");
+
+    if (placement->automatic)
+    {
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1)
+            return false;
+        // Primero un hilo por núcleo (el menor de sus hermanos), después el resto
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            {
+                if (!CPU_ISSET(cpu, &allowed))
+                    continue;
+                char path[96];
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+                int firstSibling = cpu;
+                FILE *siblings = fopen(path, "r");
+                if (siblings != NULL)
+                {
+                    if (fscanf(siblings, "%d", &firstSibling) != 1)
+                        firstSibling = cpu;
+                    fclose(siblings);
+                }
+                if ((firstSibling == cpu) == (pass == 0))
+                    placement->cpus[placement->count++] = cpu;
+            }
+        }
+        return placement->count > 0;
+    }
+
+    // Lista de CPUs y rangos: 0,2,4-7. Cada elemento empieza con un dígito, así que
+    // una coma inicial, final o repetida (elemento vacío) invalida la lista
+    const char *p = spec;
+    for (;;)
+    {
+        char *end;
+        if (!isdigit((unsigned char)*p))
+            return false;
+        long first = strtol(p, &end, 10);
+        if (first >= CPU_SETSIZE)
+            return false;
+        long last = first;
+        if (*end == '-')
+        {
+            p = end + 1;
+            if (!isdigit((unsigned char)*p))
+                return false;
+            last = strtol(p, &end, 10);
+            if (last < first || last >= CPU_SETSIZE)
+                return false;
+        }
+        for (long cpu = first; cpu <= last && placement->count < CPU_SETSIZE; cpu++)
+            placement->cpus[placement->count++] = (int)cpu;
+        if (*end == '\0')
+            break;
+        if (*end != ',')
+            return false;
+        p = end + 1;
+    }
+    return placement->count > 0;
+}
+
+int placementCpu(const Placement *placement, unsigned int slot)
+{
+    return placement->cpus[slot % (unsigned int)placement->count];
+}
+
+void pinToCpu(int cpu, const char *who)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1)
+    {
+        fprintf(stderr, "No se pudo fijar %s a la CPU %d: %s\n", who, cpu, strerror(errno));
+    }
+}
+
+// SCHED_FIFO con SCHED_RESET_ON_FORK o nice; sin permisos se avisa y se sigue igual
+void applyMasterPolicy(int fifoPriority, bool niceSet, int niceValue)
+{
+    if (fifoPriority > 0)
+    {
+        struct sched_param param = {.sched_priority = fifoPriority};
+        if (sched_setscheduler(0, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == -1)
+        {
+            fprintf(stderr, "No se pudo usar SCHED_FIFO %d para el master: %s\n", fifoPriority, strerror(errno));
+        }
+    }
+    if (niceSet && setpriority(PRIO_PROCESS, 0, niceValue) == -1)
+    {
+        fprintf(stderr, "No se pudo fijar nice %d para el master: %s\n", niceValue, strerror(errno));
+    }
+}
+
+void recordRound(RoundStats *stats, long long micros)
+{
+    if (micros < 0)
+        micros = 0;
+    unsigned int bucket = 0;
+    while (bucket < ROUND_BUCKETS - 1 && (1ULL << bucket) <= (unsigned long long)micros)
+        bucket++;
+    stats->buckets[bucket]++;
+    stats->rounds++;
+    stats->totalMicros += (unsigned long long)micros;
+    if ((unsigned long long)micros > stats->maxMicros)
+        stats->maxMicros = (unsigned long long)micros;
+}
+
+// Cota superior (potencia de 2) del percentil pedido
+unsigned long long roundPercentile(const RoundStats *stats, double fraction)
+{
+    unsigned long target = (unsigned long)(stats->rounds * fraction), seen = 0;
+    for (unsigned int bucket = 0; bucket < ROUND_BUCKETS; bucket++)
+    {
+        seen += stats->buckets[bucket];
+        if (seen > target)
+            return 1ULL << bucket;
+    }
+    return 1ULL << (ROUND_BUCKETS - 1);
+}
+
+void timedMasterEnters(Semaphores *semaphores, RoundStats *stats)
+{
+    struct timespec before, after;
+    clock_gettime(CLOCK_MONOTONIC, &before);
+    masterEnters(semaphores);
+    clock_gettime(CLOCK_MONOTONIC, &after);
+    unsigned long long waited = (unsigned long long)elapsedMicros(&before, &after);
+    stats->lockAcquisitions++;
+    stats->lockWaitMicros += waited;
+    if (waited > stats->lockWaitMaxMicros)
+        stats->lockWaitMaxMicros = waited;
+}
+
+GameState *createSharedMemoryState(unsigned short width, unsigned short height, unsigned int numPlayers, SharedPaging paging)
 {
     // Desacopla memorias compartidas anteriores
     shm_unlink("/game_state");
@@ -553,7 +1619,11 @@ GameState *createSharedMemoryState(unsigned short width, unsigned short height,
         exit(1);
     }
 
-    GameState *gameState = mmap(NULL, sizeof(GameState) + grid_size, PROT_READ | PROT_WRITE, MAP_SHARED, gameStateSmFd, 0);
+    // Para thp el madvise tiene que llegar antes de que se asignen las páginas,
+    // así que la carga anticipada se hace después con MADV_POPULATE_WRITE
+    size_t map_size = sizeof(GameState) + grid_size;
+    int flags = MAP_SHARED | (paging == PAGING_POPULATE ? MAP_POPULATE : 0);
+    GameState *gameState = mmap(NULL, map_size, PROT_READ | PROT_WRITE, flags, gameStateSmFd, 0);
     if (gameState == MAP_FAILED)
     {
         perror("Error al mapear la memoria compartida");
@@ -563,6 +1633,16 @@ GameState *createSharedMemoryState(unsigned short width, unsigned short height,
 
     close(gameStateSmFd);
 
+    if (paging == PAGING_THP)
+    {
+        if (madvise(gameState, map_size, MADV_HUGEPAGE) == -1)
+            fprintf(stderr, "madvise(MADV_HUGEPAGE) sobre /game_state: %s\n", strerror(errno));
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(gameState, map_size, MADV_POPULATE_WRITE) == -1)
+#endif
+            memset(gameState, 0, map_size);
+    }
+
     // Inicialización del estado del juego
     gameState->width = width;
     gameState->height = height;
@@ -610,6 +1690,118 @@ GameState *createSharedMemoryState(unsigned short width, unsigned short height,
     return gameState;
 }
 
+ChangeFeed *createSharedMemoryFeed(void)
+{
+    // Desacopla memorias compartidas anteriores
+    shm_unlink("/game_feed");
+
+    int feedSmFd = shm_open("/game_feed", O_CREAT | O_RDWR, 0666);
+    if (feedSmFd == -1)
+    {
+        perror("Error al crear la memoria compartida para el registro de cambios");
+        exit(1);
+    }
+
+    if (ftruncate(feedSmFd, sizeof(ChangeFeed)) == -1)
+    {
+        perror("Error al configurar el tamaño de la memoria compartida");
+        exit(1);
+    }
+
+    ChangeFeed *feed = mmap(NULL, sizeof(ChangeFeed), PROT_READ | PROT_WRITE, MAP_SHARED, feedSmFd, 0);
+    if (feed == MAP_FAILED)
+    {
+        perror("Error al mapear la memoria compartida");
+        close(feedSmFd);
+        exit(1);
+    }
+
+    close(feedSmFd);
+
+    feed->master = getpid();
+    feed->head = 0;
+    feed->round = 0;
+
+    return feed;
+}
+
+// Se llama con el lock de escritura tomado (masterEnters)
+void publishCapture(ChangeFeed *feed, unsigned int round, unsigned int player, unsigned short x, unsigned short y)
+{
+    FeedEntry *entry = &feed->entries[feed->head % FEED_CAPACITY];
+    entry->round = round;
+    entry->x = x;
+    entry->y = y;
+    entry->player = (unsigned char)player;
+    feed->head++;
+    feed->round = round;
+}
+
+HintIndex *createSharedMemoryHints(void)
+{
+    // Desacopla memorias compartidas anteriores
+    shm_unlink("/game_hints");
+
+    int hintsSmFd = shm_open("/game_hints", O_CREAT | O_RDWR, 0666);
+    if (hintsSmFd == -1)
+    {
+        perror("Error al crear la memoria compartida para las pistas");
+        exit(1);
+    }
+
+    if (ftruncate(hintsSmFd, sizeof(HintIndex)) == -1)
+    {
+        perror("Error al configurar el tamaño de la memoria compartida");
+        exit(1);
+    }
+
+    HintIndex *hints = mmap(NULL, sizeof(HintIndex), PROT_READ | PROT_WRITE, MAP_SHARED, hintsSmFd, 0);
+    if (hints == MAP_FAILED)
+    {
+        perror("Error al mapear la memoria compartida");
+        close(hintsSmFd);
+        exit(1);
+    }
+
+    close(hintsSmFd);
+
+    memset(hints, 0, sizeof(HintIndex));
+    hints->master = getpid();
+
+    return hints;
+}
+
+// Se llama con el lock de escritura tomado. Un jugador bloqueado queda sin vecinas.
+void scanNeighbours(const GameState *gameState, unsigned int player, PlayerHint *hint)
+{
+    int W = GRID_WIDTH(gameState->width), H = GRID_HEIGHT(gameState->height);
+    const Player *p = &gameState->players[player];
+
+    hint->freeMask = 0;
+    hint->freeCount = 0;
+    hint->bestMove = HINT_NONE;
+    hint->bestValue = 0;
+    if (p->blocked)
+        return;
+
+    for (int m = 0; m < 8; m++)
+    {
+        int nx = p->x + moveDx[m], ny = p->y + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= W || ny >= H)
+            continue;
+        int value = gameState->grid[ny * W + nx];
+        if (value <= 0)
+            continue;
+        hint->freeMask |= (unsigned char)(1u << m);
+        hint->freeCount++;
+        if (value > hint->bestValue)
+        {
+            hint->bestMove = (unsigned char)m;
+            hint->bestValue = (unsigned char)value;
+        }
+    }
+}
+
 Semaphores *createSharedMemorySemaphores(unsigned int numPlayers)
 {
     // Desacopla memorias compartidas anteriores
@@ -646,6 +1838,7 @@ Semaphores *createSharedMemorySemaphores(unsigned int numPlayers)
     sem_init(&semaphores->mutexGameState, 1, 1);
     sem_init(&semaphores->mutexPlayerAccess, 1, 1);
     semaphores->playersReadingState = 0;
+    semaphores->viewRecords = false;
     for (unsigned int i = 0; i < numPlayers; i++)
     {
         sem_init(&semaphores->playerCanMove[i], 1, 0);
@@ -683,8 +1876,22 @@ void cleanup_resources(unsigned int width, unsigned int height, unsigned int num
         }
     }
 
+    if (g_feed != NULL)
+    {
+        munmap(g_feed, sizeof(ChangeFeed));
+        g_feed = NULL;
+    }
+
+    if (g_hints != NULL)
+    {
+        munmap(g_hints, sizeof(HintIndex));
+        g_hints = NULL;
+    }
+
     shm_unlink("/game_state");
     shm_unlink("/game_sync");
+    shm_unlink("/game_feed");
+    shm_unlink("/game_hints");
 }
 
 void signal_handler(int sig)
@@ -692,15 +1899,3 @@ void signal_handler(int sig)
     cleanup_resources(g_width, g_height, g_numPlayers, g_gameState, g_semaphores);
     exit(sig);
 }
-
-void masterEnters(Semaphores *semaphores)
-{
-    sem_wait(&semaphores->mutexMasterAccess);
-    sem_wait(&semaphores->mutexGameState);
-    sem_post(&semaphores->mutexMasterAccess);
-}
-
-void masterLeaves(Semaphores *semaphores)
-{
-    sem_post(&semaphores->mutexGameState);
-}
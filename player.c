@@ -14,10 +14,216 @@
 #include <stdbool.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <signal.h>
 
 
-void acquireGameStatePlayerLock(Semaphores *semaphore);
-void releaseGameStatePlayerLock(Semaphores *semaphore);
+#include "bitboard.h"
+
+// Desplazamiento (dx, dy) de cada movimiento: 0 arriba y en sentido horario
+static const int moveDx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int moveDy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+// Copia privada del tablero: celdas libres, un plano por valor de celda y la
+// posición de cada jugador al momento de la copia
+typedef struct
+{
+    Bitboard free;
+    Bitboard values[10];
+    Bitboard region;
+    Bitboard visited;
+    unsigned char *cellValues; // valor de cada celda libre, 0 si está capturada
+    unsigned int playersNumber;
+    int x[MAX_PLAYERS], y[MAX_PLAYERS];
+    bool blocked[MAX_PLAYERS];
+} BoardMirror;
+
+bool initMirror(BoardMirror *mirror, unsigned int width, unsigned int height);
+void mirrorGrid(BoardMirror *mirror, const GameState *gameState);
+void mirrorPlayers(BoardMirror *mirror, const GameState *gameState);
+bool mirrorFeed(BoardMirror *mirror, const GameState *gameState, const ChangeFeed *feed, unsigned long long *consumed);
+unsigned int regionValue(const BoardMirror *mirror, const Bitboard *region);
+void evaluateMove(BoardMirror *mirror, int x, int y, unsigned int *cells, unsigned int *value);
+unsigned char chooseMovement(BoardMirror *mirror, int currentX, int currentY);
+struct timespec deadlineAfter(struct timespec start, unsigned int ms);
+bool pastDeadline(const struct timespec *deadline);
+
+// Final de partida: cuando la región alcanzable no toca a ningún oponente el
+// puntaje solo depende del camino más valioso dentro de ella. Regiones chicas se
+// resuelven de forma exacta (DFS con memoización sobre máscaras de 64 bits); las
+// grandes con DFS acotado por tiempo, orden de Warnsdorff y poda por cota superior.
+#ifndef ENDGAME_BUDGET_MS
+#define ENDGAME_BUDGET_MS 20        // plazo por movimiento del jugador base
+#endif
+#define ENDGAME_EXACT_CELLS 32
+#define ENDGAME_MEMO_BITS 16
+#define ENDGAME_START 64            // posición "cabeza" en el solver exacto
+
+typedef struct
+{
+    uint64_t rest;        // celdas de la región todavía libres (canonizadas)
+    int value;
+    unsigned char pos;
+    bool used;
+} EndgameMemo;
+
+typedef struct
+{
+    int x, y;
+    unsigned char moves[8];
+    unsigned char count, next;
+} EndgameFrame;
+
+typedef struct
+{
+    Bitboard region, heads, scratch, work;
+    int *cellIndex;                 // índice en la región chica de cada celda, o -1
+    EndgameMemo *memo;
+    EndgameFrame *stack;
+    unsigned char *path;            // mejor camino conocido, como movimientos
+    int pathLen, pathPos;
+    bool pathExact;
+    int expectedX, expectedY;       // posición en la que debería estar para seguir el camino
+    int n;                          // región chica: celdas, valores y adyacencias
+    int cx[64], cy[64];
+    unsigned char value[64];
+    uint64_t adj[64];
+    uint64_t startAdj;
+    struct timespec deadline;
+    bool aborted;
+} Endgame;
+
+bool initEndgame(Endgame *endgame, unsigned int width, unsigned int height);
+bool endgameMovement(Endgame *endgame, BoardMirror *mirror, int self, unsigned int budgetMs,
+                     struct timespec start, unsigned char *movement);
+
+#ifdef PLAYER_SEARCH
+// Variante con búsqueda: profundización iterativa sobre los movimientos propios y
+// del oponente más cercano, evaluando territorio de Voronoi, con una tabla de
+// transposición que se conserva entre turnos. Es una reducción a dos jugadores:
+// solo se ramifica sobre un oponente a distancia SEARCH_NEARBY_DISTANCE o menos;
+// el resto queda fijo en su cabeza actual y solo cuenta en la evaluación.
+#ifndef SEARCH_BUDGET_MS
+#define SEARCH_BUDGET_MS 50         // plazo por movimiento si no se pasa argv[3]
+#endif
+#define SEARCH_MAX_DEPTH 32
+#define SEARCH_NEARBY_DISTANCE 8    // distancia de Chebyshev para considerar a un oponente
+#define TT_BITS 18
+
+#define TT_EXACT 0
+#define TT_LOWER 1
+#define TT_UPPER 2
+
+typedef struct
+{
+    uint64_t key;
+    int value;            // puntaje relativo al acumulado en el nodo
+    unsigned char depth;
+    unsigned char flag;
+    unsigned char move;
+} TTEntry;
+
+typedef struct
+{
+    BoardMirror *mirror;
+    int self;
+    int opponent;         // índice del oponente buscado, -1 si no hay ninguno cerca
+    uint64_t *zobristCell;
+    uint64_t *zobristPos;
+    uint64_t zobristSide;
+    TTEntry *table;
+    Bitboard mine, theirs, next, claimed;
+    struct timespec deadline;
+    bool aborted;
+} Search;
+
+// Posición dentro de la búsqueda: cabezas de ambos lados, diferencia de
+// puntaje acumulada en el camino y hash de Zobrist del tablero
+typedef struct
+{
+    int x[2], y[2];
+    int pathScore;
+    uint64_t hash;
+} SearchNode;
+
+bool initSearch(Search *search, BoardMirror *mirror, unsigned int width, unsigned int height);
+unsigned char searchMovement(Search *search, int self, unsigned int budgetMs, struct timespec start);
+#endif
+
+#ifdef PLAYER_MONTECARLO
+// Variante Monte Carlo: se recorta una ventana del tablero alrededor de la cabeza
+// y un pool de hilos corre simulaciones aleatorias (sesgadas por valor) de cada
+// movimiento candidato hasta el plazo. Las tareas son lotes de simulaciones en
+// colas por hilo con robo de trabajo; los tableros de simulación salen de un pool
+// propio de cada hilo.
+#include <pthread.h>
+
+#ifndef MC_BUDGET_MS
+#define MC_BUDGET_MS 50             // plazo por movimiento si no se pasa argv[3]
+#endif
+#ifndef MC_THREADS
+#define MC_THREADS 0                // 0: un hilo por CPU en línea (argv[4] lo reemplaza)
+#endif
+#define MC_RADIUS 12
+#define MC_SIDE (2 * MC_RADIUS + 1)
+#define MC_HORIZON MC_RADIUS        // pasos simulados por rollout
+#define MC_BATCH 32                 // rollouts por tarea
+#define MC_QUEUE_SIZE 64
+#define MC_POOL_CHUNK 16
+
+typedef struct RolloutBoard
+{
+    unsigned char cells[MC_SIDE * MC_SIDE]; // valor de la celda, 0 si no se puede pisar
+    struct RolloutBoard *nextFree;
+} RolloutBoard;
+
+typedef struct
+{
+    unsigned char candidate;
+    unsigned short rollouts;
+} RolloutTask;
+
+typedef struct RolloutPool RolloutPool;
+
+typedef struct
+{
+    RolloutPool *pool;
+    pthread_t thread;
+    pthread_mutex_t queueLock;
+    RolloutTask queue[MC_QUEUE_SIZE]; // el dueño saca del fondo, los ladrones del frente
+    int head, tail;
+    RolloutBoard *freeBoards;         // lista libre de tableros del hilo
+    uint64_t rng;
+    double sum[8];
+    unsigned long count[8];
+    unsigned long steals;
+    char padding[64];
+} RolloutWorker;
+
+struct RolloutPool
+{
+    RolloutWorker *workers;
+    int threads;
+    pthread_mutex_t lock;
+    pthread_cond_t start, done;
+    unsigned long generation;
+    int finished;
+    bool shutdown;
+    // Trabajo del turno actual (escrito por el hilo principal antes de despertar al pool)
+    RolloutBoard snapshot;
+    int opponentX[MAX_PLAYERS], opponentY[MAX_PLAYERS];
+    int opponents;
+    unsigned char candidates[8];
+    int candidatesCount;
+    struct timespec deadline;
+    unsigned long totalRollouts;
+    unsigned long totalSteals;
+    double wallSeconds;         // tiempo de reloj con el pool trabajando
+};
+
+bool initRolloutPool(RolloutPool *pool, int threads);
+unsigned char monteCarloMovement(RolloutPool *pool, BoardMirror *mirror, int self, unsigned int budgetMs, struct timespec start);
+void destroyRolloutPool(RolloutPool *pool);
+#endif
 
 
 int main(int argc, char *argv[]) {
@@ -33,98 +239,1161 @@ int main(int argc, char *argv[]) {
 
     GameState *gameState = connectToSharedMemoryState(width, height);
     Semaphores *semaphores = connectToSharedMemorySemaphores();
+    // El registro de cambios es opcional: sin él se vuelve a copiar la grilla entera en cada turno
+    ChangeFeed *feed = connectToSharedMemoryFeed();
+    unsigned long long consumed = 0;
+    bool mirrored = false;
+    // Las pistas también son opcionales: con una sola vecina libre el movimiento es forzado
+    HintIndex *hints = connectToSharedMemoryHints();
 
-    //Determinación del indice del arreglo de semaforos correspondiente al jugador actual
+    //Determinación del indice del arreglo de semaforos correspondiente al jugador actual.
+    //El master registra el pid después del fork, así que puede no estar todavía: se reintenta un rato.
     int playerIndex = -1;
-    for (int i = 0; i < MAX_PLAYERS && playerIndex == -1; i++) {
-        if (gameState->players[i].pid == getpid()) {
-            playerIndex = i;
+    for (int attempt = 0; attempt < 1000 && playerIndex == -1; attempt++) {
+        for (int i = 0; i < MAX_PLAYERS && playerIndex == -1; i++) {
+            if (gameState->players[i].pid == getpid()) {
+                playerIndex = i;
+            }
+        }
+        if (playerIndex == -1) {
+            usleep(1000);
         }
     }
     if (playerIndex == -1) {
         fprintf(stderr, "No se encontró el índice del jugador para el PID actual\n");
         return 1;
     }
+#if defined(FIXED_WIDTH) || defined(FIXED_HEIGHT) || defined(FIXED_PLAYERS)
+    if (width != GRID_WIDTH(width) || height != GRID_HEIGHT(height) ||
+        gameState->playersNumber != GRID_PLAYERS(gameState->playersNumber)) {
+        fprintf(stderr, "Jugador especializado para otra configuración: %ux%u con %u jugadores\n",
+                width, height, gameState->playersNumber);
+        return 1;
+    }
+#endif
+
+    BoardMirror mirror;
+    if (!initMirror(&mirror, width, height)) {
+        fprintf(stderr, "No se pudo reservar memoria para el tablero del jugador\n");
+        return 1;
+    }
+
+#ifdef PLAYER_SEARCH
+    unsigned int budgetMs = argc > 3 ? (unsigned int)atoi(argv[3]) : SEARCH_BUDGET_MS;
+    Search search;
+    if (!initSearch(&search, &mirror, width, height)) {
+        fprintf(stderr, "No se pudo reservar memoria para la búsqueda\n");
+        return 1;
+    }
+#elif defined(PLAYER_MONTECARLO)
+    unsigned int budgetMs = argc > 3 ? (unsigned int)atoi(argv[3]) : MC_BUDGET_MS;
+    int threads = argc > 4 ? atoi(argv[4]) : MC_THREADS;
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    RolloutPool pool;
+    if (!initRolloutPool(&pool, threads)) {
+        fprintf(stderr, "No se pudo crear el pool de hilos de simulación\n");
+        return 1;
+    }
+#else
+    unsigned int budgetMs = argc > 3 ? (unsigned int)atoi(argv[3]) : ENDGAME_BUDGET_MS;
+#endif
+    Endgame endgame;
+    if (!initEndgame(&endgame, width, height)) {
+        fprintf(stderr, "No se pudo reservar memoria para el solver de final de partida\n");
+        return 1;
+    }
 
     bool isOver = false;
+    signal(SIGPIPE, SIG_IGN);
 
 
 
     while(!isOver){
 
         sem_wait(&semaphores->playerCanMove[playerIndex]);
+        struct timespec turnStart;
+        clock_gettime(CLOCK_MONOTONIC, &turnStart);
 
+        // Bajo el lock solo se actualiza la copia; la evaluación se hace con el lock liberado.
+        // Con registro de cambios se aplican solo las capturas nuevas, salvo la primera vez
+        // o si el jugador quedó más de FEED_CAPACITY entradas atrás.
+        // Si la pista dice que hay una sola salida no hace falta ni la copia ni la evaluación.
         acquireGameStatePlayerLock(semaphores);
 
-        int currentX = (int)gameState->players[playerIndex].x; // columnas
-        int currentY = (int)gameState->players[playerIndex].y; // filas
-
-
-        unsigned int W = gameState->width;
-        unsigned int H = gameState->height;
-        unsigned char movement = 9; 
-        int bestVal = -1;
-        
-
-        for(int dy=-1; dy<=1; dy++){
-            for(int dx=-1; dx<=1; dx++){
-                
-                if(dx == 0 && dy == 0) 
-                continue; // ignora la celda actual
-                
-                int neighborX = currentX + dx;
-                int neighborY = currentY + dy;
-                
-                if (neighborX >= 0 && neighborX < (int)W && neighborY >= 0 && neighborY < (int)H) 
-                {
-                    int val = gameState->grid[neighborY * W + neighborX];
-                    
-                    if(val > bestVal){
-                        bestVal = val;
-                        // Conversion de (dx,dy) al movimiento del jugador
-                        if(dx == 0 && dy == -1){ movement = 0; }           // arriba
-                        else if(dx == 1 && dy == -1){ movement = 1; }      // arriba-derecha
-                        else if(dx == 1 && dy == 0){ movement = 2; }       // derecha
-                        else if(dx == 1 && dy == 1){ movement = 3; }       // abajo-derecha
-                        else if(dx == 0 && dy == 1){ movement = 4; }       // abajo
-                        else if(dx == -1 && dy == 1){ movement = 5; }      // abajo-izquierda
-                        else if(dx == -1 && dy == 0){ movement = 6; }      // izquierda
-                        else if(dx == -1 && dy == -1){ movement = 7; }     // arriba-izquierda
-                    }
-                }
+        unsigned char forced = HINT_NONE;
+        if (hints != NULL && hints->players[playerIndex].freeCount == 1) {
+            forced = hints->players[playerIndex].bestMove;
+        } else if (!mirrored || feed == NULL || !mirrorFeed(&mirror, gameState, feed, &consumed)) {
+            mirrorGrid(&mirror, gameState);
+            if (feed != NULL) {
+                consumed = feed->head;
             }
+            mirrored = true;
         }
 
-
         releaseGameStatePlayerLock(semaphores);
 
+        unsigned char movement = forced;
+        if (forced == HINT_NONE && !endgameMovement(&endgame, &mirror, playerIndex, budgetMs, turnStart, &movement)) {
+#ifdef PLAYER_SEARCH
+            movement = searchMovement(&search, playerIndex, budgetMs, turnStart);
+#elif defined(PLAYER_MONTECARLO)
+            movement = monteCarloMovement(&pool, &mirror, playerIndex, budgetMs, turnStart);
+#else
+            movement = chooseMovement(&mirror, mirror.x[playerIndex], mirror.y[playerIndex]);
+#endif
+        }
+
         if (gameState->gameOver){
             isOver = true;
         }
 
-        write(1, &movement, sizeof(movement));
+        // Al terminar la partida el master cierra el pipe: EPIPE en lugar de SIGPIPE
+        if (write(1, &movement, sizeof(movement)) == -1 && errno == EPIPE) {
+            isOver = true;
+        }
 
     }
+#ifdef PLAYER_MONTECARLO
+    destroyRolloutPool(&pool);
+#endif
     return 0;
 }
 
-void acquireGameStatePlayerLock(Semaphores *semaphore)
+bool initMirror(BoardMirror *mirror, unsigned int width, unsigned int height)
+{
+    mirror->cellValues = calloc((size_t)width * height, 1);
+    bool ok = mirror->cellValues != NULL &&
+              bbInit(&mirror->free, width, height) &&
+              bbInit(&mirror->region, width, height) &&
+              bbInit(&mirror->visited, width, height);
+    for (int v = 1; v <= 9 && ok; v++) {
+        ok = bbInit(&mirror->values[v], width, height);
+    }
+    return ok;
+}
+
+void mirrorGrid(BoardMirror *mirror, const GameState *gameState)
+{
+    unsigned int W = GRID_WIDTH(gameState->width);
+    unsigned int H = GRID_HEIGHT(gameState->height);
+
+    bbClear(&mirror->free);
+    for (int v = 1; v <= 9; v++) {
+        bbClear(&mirror->values[v]);
+    }
+
+    for (unsigned int y = 0; y < H; y++) {
+        const int *row = &gameState->grid[y * W];
+        for (unsigned int x = 0; x < W; x++) {
+            int v = row[x];
+            if (v > 0) {
+                if (v > 9)
+                    v = 9;
+                bbSet(&mirror->free, x, y);
+                bbSet(&mirror->values[v], x, y);
+                mirror->cellValues[y * W + x] = (unsigned char)v;
+            } else {
+                mirror->cellValues[y * W + x] = 0;
+            }
+        }
+    }
+
+    mirrorPlayers(mirror, gameState);
+}
+
+void mirrorPlayers(BoardMirror *mirror, const GameState *gameState)
+{
+    mirror->playersNumber = gameState->playersNumber;
+    for (unsigned int i = 0; i < gameState->playersNumber && i < MAX_PLAYERS; i++) {
+        mirror->x[i] = gameState->players[i].x;
+        mirror->y[i] = gameState->players[i].y;
+        mirror->blocked[i] = gameState->players[i].blocked;
+    }
+}
+
+// Aplica a la copia las capturas publicadas desde la última llamada. Devuelve false
+// si el master ya sobrescribió entradas no leídas; en ese caso hay que recopiar todo.
+bool mirrorFeed(BoardMirror *mirror, const GameState *gameState, const ChangeFeed *feed, unsigned long long *consumed)
+{
+    unsigned long long head = feed->head;
+    if (head - *consumed > FEED_CAPACITY) {
+        return false;
+    }
+
+    unsigned int W = GRID_WIDTH(gameState->width);
+    for (; *consumed < head; (*consumed)++) {
+        const FeedEntry *entry = &feed->entries[*consumed % FEED_CAPACITY];
+        unsigned int pos = entry->y * W + entry->x;
+        unsigned char v = mirror->cellValues[pos];
+        if (v > 0) {
+            bbReset(&mirror->free, entry->x, entry->y);
+            bbReset(&mirror->values[v], entry->x, entry->y);
+            mirror->cellValues[pos] = 0;
+        }
+    }
+
+    mirrorPlayers(mirror, gameState);
+    return true;
+}
+
+unsigned int regionValue(const BoardMirror *mirror, const Bitboard *region)
+{
+    unsigned int value = 0;
+    for (int v = 1; v <= 9; v++) {
+        value += v * bbCountAnd(region, &mirror->values[v]);
+    }
+    return value;
+}
+
+// Celdas y puntaje alcanzables si el jugador se mueve a (x, y): la celda misma más
+// la mejor de las regiones a las que se puede seguir desde ella.
+void evaluateMove(BoardMirror *mirror, int x, int y, unsigned int *cells, unsigned int *value)
+{
+    unsigned int bestCells = 0, bestValue = 0;
+
+    bbReset(&mirror->free, x, y);
+    bbClear(&mirror->visited);
+
+    for (int m = 0; m < 8; m++) {
+        int nx = x + moveDx[m];
+        int ny = y + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= (int)BB_WIDTH(&mirror->free) || ny >= (int)BB_HEIGHT(&mirror->free))
+            continue;
+        if (!bbTest(&mirror->free, nx, ny) || bbTest(&mirror->visited, nx, ny))
+            continue;
+
+        bbClear(&mirror->region);
+        bbSet(&mirror->region, nx, ny);
+        unsigned int regionCells = bbFloodFill(&mirror->region, &mirror->free);
+        unsigned int value = regionValue(mirror, &mirror->region);
+        bbOr(&mirror->visited, &mirror->region);
+
+        if (regionCells > bestCells || (regionCells == bestCells && value > bestValue)) {
+            bestCells = regionCells;
+            bestValue = value;
+        }
+    }
+
+    bbSet(&mirror->free, x, y);
+
+    unsigned int cellValue = mirror->cellValues[y * BB_WIDTH(&mirror->free) + x];
+    *cells = 1 + bestCells;
+    *value = cellValue + bestValue;
+}
+
+// Elige el vecino libre que deja más celdas por recorrer; a igualdad, el de mayor
+// valor inmediato y luego el de mayor puntaje alcanzable.
+unsigned char chooseMovement(BoardMirror *mirror, int currentX, int currentY)
+{
+    unsigned char movement = 9;
+    unsigned int bestCells = 0, bestValue = 0, bestReach = 0;
+
+    for (int m = 0; m < 8; m++) {
+        int nx = currentX + moveDx[m];
+        int ny = currentY + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= (int)BB_WIDTH(&mirror->free) || ny >= (int)BB_HEIGHT(&mirror->free))
+            continue;
+        if (!bbTest(&mirror->free, nx, ny))
+            continue;
+
+        unsigned int cellValue = mirror->cellValues[ny * BB_WIDTH(&mirror->free) + nx];
+        unsigned int cells, reach;
+        evaluateMove(mirror, nx, ny, &cells, &reach);
+
+        if (movement == 9 || cells > bestCells ||
+            (cells == bestCells && (cellValue > bestValue || (cellValue == bestValue && reach > bestReach)))) {
+            movement = (unsigned char)m;
+            bestCells = cells;
+            bestValue = cellValue;
+            bestReach = reach;
+        }
+    }
+    return movement;
+}
+
+struct timespec deadlineAfter(struct timespec start, unsigned int ms)
+{
+    struct timespec deadline;
+    deadline.tv_sec = start.tv_sec + ms / 1000;
+    deadline.tv_nsec = start.tv_nsec + (long)(ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+bool pastDeadline(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+bool initEndgame(Endgame *endgame, unsigned int width, unsigned int height)
+{
+    size_t cells = (size_t)width * height;
+    memset(endgame, 0, sizeof(*endgame));
+    endgame->cellIndex = malloc(cells * sizeof(int));
+    endgame->memo = calloc((size_t)1 << ENDGAME_MEMO_BITS, sizeof(EndgameMemo));
+    endgame->stack = malloc((cells + 1) * sizeof(EndgameFrame));
+    endgame->path = malloc(cells + 1);
+    if (endgame->cellIndex == NULL || endgame->memo == NULL || endgame->stack == NULL || endgame->path == NULL)
+        return false;
+    for (size_t i = 0; i < cells; i++)
+        endgame->cellIndex[i] = -1;
+    return bbInit(&endgame->region, width, height) && bbInit(&endgame->heads, width, height) &&
+           bbInit(&endgame->scratch, width, height) && bbInit(&endgame->work, width, height);
+}
+
+static int moveTowards(int fromX, int fromY, int toX, int toY)
+{
+    for (int m = 0; m < 8; m++) {
+        if (fromX + moveDx[m] == toX && fromY + moveDy[m] == toY)
+            return m;
+    }
+    return -1;
+}
+
+// Mejor valor obtenible desde pos usando las celdas de rest (sin contar pos).
+// rest se reduce a la componente alcanzable antes de consultar la memoización.
+static int exactBest(Endgame *endgame, int pos, uint64_t rest)
+{
+    if (endgame->aborted)
+        return 0;
+    uint64_t options = (pos == ENDGAME_START ? endgame->startAdj : endgame->adj[pos]) & rest;
+    if (!options)
+        return 0;
+
+    uint64_t component = options, frontier = options;
+    while (frontier) {
+        uint64_t grown = 0;
+        for (uint64_t f = frontier; f; f &= f - 1)
+            grown |= endgame->adj[__builtin_ctzll(f)];
+        frontier = grown & rest & ~component;
+        component |= frontier;
+    }
+    rest = component;
+
+    uint64_t h = (rest ^ ((uint64_t)pos * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+    EndgameMemo *entry = &endgame->memo[h >> (64 - ENDGAME_MEMO_BITS)];
+    if (entry->used && entry->rest == rest && entry->pos == pos)
+        return entry->value;
+
+    if (pastDeadline(&endgame->deadline)) {
+        endgame->aborted = true;
+        return 0;
+    }
+
+    int best = 0;
+    for (uint64_t o = options; o; o &= o - 1) {
+        int c = __builtin_ctzll(o);
+        int value = endgame->value[c] + exactBest(endgame, c, rest & ~(1ULL << c));
+        if (value > best)
+            best = value;
+    }
+
+    if (!endgame->aborted) {
+        entry->used = true;
+        entry->rest = rest;
+        entry->pos = (unsigned char)pos;
+        entry->value = best;
+    }
+    return best;
+}
+
+static bool solveExact(Endgame *endgame, const BoardMirror *mirror, int x, int y)
+{
+    unsigned int W = BB_WIDTH(&mirror->free), H = BB_HEIGHT(&mirror->free);
+
+    endgame->n = 0;
+    for (unsigned int row = 0; row < H; row++) {
+        for (unsigned int col = 0; col < W; col++) {
+            if (bbTest(&endgame->region, col, row)) {
+                endgame->cellIndex[row * W + col] = endgame->n;
+                endgame->cx[endgame->n] = (int)col;
+                endgame->cy[endgame->n] = (int)row;
+                endgame->value[endgame->n] = mirror->cellValues[row * W + col];
+                endgame->n++;
+            }
+        }
+    }
+
+    endgame->startAdj = 0;
+    for (int i = 0; i < endgame->n; i++) {
+        endgame->adj[i] = 0;
+        for (int m = 0; m < 8; m++) {
+            int nx = endgame->cx[i] + moveDx[m], ny = endgame->cy[i] + moveDy[m];
+            if (nx < 0 || ny < 0 || nx >= (int)W || ny >= (int)H)
+                continue;
+            int j = endgame->cellIndex[ny * W + nx];
+            if (j >= 0)
+                endgame->adj[i] |= 1ULL << j;
+        }
+        if (abs(endgame->cx[i] - x) <= 1 && abs(endgame->cy[i] - y) <= 1)
+            endgame->startAdj |= 1ULL << i;
+    }
+
+    memset(endgame->memo, 0, ((size_t)1 << ENDGAME_MEMO_BITS) * sizeof(EndgameMemo));
+    uint64_t rest = endgame->n == 64 ? ~0ULL : (1ULL << endgame->n) - 1;
+    int total = exactBest(endgame, ENDGAME_START, rest);
+
+    // Reconstrucción del camino siguiendo, en cada paso, el sucesor que alcanza el óptimo.
+    // Se arma aparte: si se acaba el tiempo, el camino que se venía siguiendo queda intacto.
+    unsigned char path[64];
+    int pathLen = 0;
+    int pos = ENDGAME_START, px = x, py = y;
+    while (!endgame->aborted && total > 0) {
+        uint64_t options = (pos == ENDGAME_START ? endgame->startAdj : endgame->adj[pos]) & rest;
+        int next = -1;
+        for (uint64_t o = options; o && next < 0; o &= o - 1) {
+            int c = __builtin_ctzll(o);
+            if (endgame->value[c] + exactBest(endgame, c, rest & ~(1ULL << c)) == total)
+                next = c;
+        }
+        if (next < 0)
+            break;
+        path[pathLen++] = (unsigned char)moveTowards(px, py, endgame->cx[next], endgame->cy[next]);
+        total -= endgame->value[next];
+        rest &= ~(1ULL << next);
+        pos = next;
+        px = endgame->cx[next];
+        py = endgame->cy[next];
+    }
+
+    for (int i = 0; i < endgame->n; i++)
+        endgame->cellIndex[endgame->cy[i] * W + endgame->cx[i]] = -1;
+
+    if (endgame->aborted || total != 0)
+        return false;
+    memcpy(endgame->path, path, (size_t)pathLen);
+    endgame->pathLen = pathLen;
+    endgame->pathPos = 0;
+    endgame->pathExact = true;
+    return true;
+}
+
+static int onwardMoves(const Bitboard *work, int x, int y)
+{
+    int count = 0;
+    for (int m = 0; m < 8; m++) {
+        int nx = x + moveDx[m], ny = y + moveDy[m];
+        if (nx >= 0 && ny >= 0 && nx < (int)BB_WIDTH(work) && ny < (int)BB_HEIGHT(work) && bbTest(work, nx, ny))
+            count++;
+    }
+    return count;
+}
+
+// Candidatos ordenados por Warnsdorff: primero el que deja menos salidas, a igualdad el de mayor valor
+static unsigned char orderedMoves(const Bitboard *work, const BoardMirror *mirror, int x, int y, unsigned char *moves)
+{
+    unsigned int W = BB_WIDTH(work);
+    int keys[8];
+    unsigned char count = 0;
+    for (int m = 0; m < 8; m++) {
+        int nx = x + moveDx[m], ny = y + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= (int)W || ny >= (int)BB_HEIGHT(work) || !bbTest(work, nx, ny))
+            continue;
+        int key = onwardMoves(work, nx, ny) * 16 - mirror->cellValues[ny * W + nx];
+        int j = count++;
+        while (j > 0 && keys[j - 1] > key) {
+            keys[j] = keys[j - 1];
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        moves[j] = (unsigned char)m;
+    }
+    return count;
+}
+
+// DFS iterativo (sin recursión: el camino puede ser tan largo como el tablero)
+// que mejora el camino guardado hasta que se agota el plazo.
+static void solveBounded(Endgame *endgame, const BoardMirror *mirror, int x, int y, int incumbent)
 {
-    sem_wait(&semaphore->mutexMasterAccess);  // Espera si el master esta escribiendo
-    sem_post(&semaphore->mutexMasterAccess);  // De lo contrario, libera el control del master inmediatamente
+    unsigned int W = BB_WIDTH(&mirror->free);
+    Bitboard *work = &endgame->work;
+    bbCopy(work, &endgame->region);
 
-    sem_wait(&semaphore->mutexPlayerAccess);
-    if (semaphore->playersReadingState++ == 0) {
-        sem_wait(&semaphore->mutexGameState); // el primer lector toma el mutex
+    int remaining = (int)regionValue(mirror, work);
+    int pathValue = 0, best = incumbent;
+    int depth = 0;
+    EndgameFrame *stack = endgame->stack;
+    stack[0].x = x;
+    stack[0].y = y;
+    stack[0].next = 0;
+    stack[0].count = orderedMoves(work, mirror, x, y, stack[0].moves);
+
+    unsigned long nodes = 0;
+    while (depth >= 0) {
+        // Sin ningún camino todavía se completa al menos el primer descenso
+        if ((++nodes & 255) == 0 && best >= 0 && pastDeadline(&endgame->deadline))
+            break;
+
+        EndgameFrame *frame = &stack[depth];
+        if (frame->next == frame->count || pathValue + remaining <= best) {
+            if (frame->count == 0 && pathValue > best) {
+                best = pathValue;
+                for (int i = 0; i < depth; i++)
+                    endgame->path[i] = stack[i].moves[stack[i].next - 1];
+                endgame->pathLen = depth;
+                endgame->pathPos = 0;
+            }
+            if (depth > 0) {
+                int value = mirror->cellValues[frame->y * W + frame->x];
+                bbSet(work, frame->x, frame->y);
+                pathValue -= value;
+                remaining += value;
+            }
+            depth--;
+            continue;
+        }
+
+        unsigned char m = frame->moves[frame->next++];
+        int nx = frame->x + moveDx[m], ny = frame->y + moveDy[m];
+        int value = mirror->cellValues[ny * W + nx];
+        bbReset(work, nx, ny);
+        pathValue += value;
+        remaining -= value;
+
+        EndgameFrame *child = &stack[++depth];
+        child->x = nx;
+        child->y = ny;
+        child->next = 0;
+        child->count = orderedMoves(work, mirror, nx, ny, child->moves);
+    }
+}
+
+// Devuelve true (y el movimiento) si el jugador está sellado en una región propia
+bool endgameMovement(Endgame *endgame, BoardMirror *mirror, int self, unsigned int budgetMs,
+                     struct timespec start, unsigned char *movement)
+{
+    unsigned int W = BB_WIDTH(&mirror->free);
+    int x = mirror->x[self], y = mirror->y[self];
+
+    if (bbReachableFrom(&endgame->region, &mirror->free, x, y) == 0) {
+        endgame->pathLen = 0;
+        return false;
+    }
+    bbClear(&endgame->heads);
+    for (unsigned int i = 0; i < GRID_PLAYERS(mirror->playersNumber); i++) {
+        if ((int)i != self)
+            bbSet(&endgame->heads, mirror->x[i], mirror->y[i]);
+    }
+    if (!bbRegionIsolated(&endgame->region, &endgame->heads, &endgame->scratch)) {
+        endgame->pathLen = 0;
+        return false;
+    }
+
+    endgame->deadline = deadlineAfter(start, budgetMs);
+    endgame->aborted = false;
+
+    // ¿Sigue siendo válido el resto del camino calculado en turnos anteriores?
+    bool following = endgame->pathPos < endgame->pathLen && x == endgame->expectedX && y == endgame->expectedY;
+    int incumbent = 0;
+    for (int i = endgame->pathPos, px = x, py = y; following && i < endgame->pathLen; i++) {
+        px += moveDx[endgame->path[i]];
+        py += moveDy[endgame->path[i]];
+        if (!bbTest(&endgame->region, px, py))
+            following = false;
+        else
+            incumbent += mirror->cellValues[py * W + px];
+    }
+    if (following) {
+        memmove(endgame->path, endgame->path + endgame->pathPos, endgame->pathLen - endgame->pathPos);
+        endgame->pathLen -= endgame->pathPos;
+        endgame->pathPos = 0;
+    } else {
+        endgame->pathLen = 0;
+        endgame->pathPos = 0;
+        endgame->pathExact = false;
+        incumbent = 0;
+    }
+
+    if (!(following && endgame->pathExact)) {
+        bool solved = bbCount(&endgame->region) <= ENDGAME_EXACT_CELLS && solveExact(endgame, mirror, x, y);
+        if (!solved) {
+            if (!following)
+                endgame->pathLen = 0;
+            endgame->pathExact = false;
+            solveBounded(endgame, mirror, x, y, following ? incumbent : -1);
+        }
+    }
+
+    if (endgame->pathPos >= endgame->pathLen)
+        return false;
+
+    *movement = endgame->path[endgame->pathPos++];
+    endgame->expectedX = x + moveDx[*movement];
+    endgame->expectedY = y + moveDy[*movement];
+    return true;
+}
+
+#ifdef PLAYER_SEARCH
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+bool initSearch(Search *search, BoardMirror *mirror, unsigned int width, unsigned int height)
+{
+    size_t cells = (size_t)width * height;
+    search->mirror = mirror;
+    search->zobristCell = malloc(cells * sizeof(uint64_t));
+    search->zobristPos = malloc(cells * sizeof(uint64_t));
+    search->table = calloc((size_t)1 << TT_BITS, sizeof(TTEntry));
+    if (search->zobristCell == NULL || search->zobristPos == NULL || search->table == NULL)
+        return false;
+
+    uint64_t seed = 0x5EED;
+    for (size_t i = 0; i < cells; i++) {
+        search->zobristCell[i] = splitmix64(&seed);
+        search->zobristPos[i] = splitmix64(&seed);
+    }
+    search->zobristSide = splitmix64(&seed);
+
+    return bbInit(&search->mine, width, height) && bbInit(&search->theirs, width, height) &&
+           bbInit(&search->next, width, height) && bbInit(&search->claimed, width, height);
+}
+
+static bool timeIsUp(Search *search)
+{
+    if (pastDeadline(&search->deadline))
+        search->aborted = true;
+    return search->aborted;
+}
+
+// Hash de cabezas sin otra tabla: el lado 1 y las cabezas fijas (lado 2, oponentes
+// que no se ramifican) usan rotaciones distintas de la misma clave
+static uint64_t positionKey(const Search *search, int side, unsigned int cell)
+{
+    uint64_t k = search->zobristPos[cell];
+    return side == 0 ? k : side == 1 ? (k << 17) | (k >> 47) : (k << 41) | (k >> 23);
+}
+
+// Territorio de Voronoi: BFS simultáneo por capas desde la cabeza propia y desde
+// todos los oponentes; las celdas que ambos alcanzan en la misma capa son neutrales.
+// Devuelve el valor de las celdas propias menos el de las ajenas.
+static int voronoiScore(Search *search, const SearchNode *node)
+{
+    BoardMirror *mirror = search->mirror;
+    size_t words = (size_t)BB_WORDS(&mirror->free) * BB_HEIGHT(&mirror->free);
+
+    bbClear(&search->mine);
+    bbClear(&search->theirs);
+    bbSet(&search->mine, node->x[0], node->y[0]);
+    for (unsigned int i = 0; i < GRID_PLAYERS(mirror->playersNumber); i++) {
+        if ((int)i == search->self || mirror->blocked[i])
+            continue;
+        if ((int)i == search->opponent)
+            bbSet(&search->theirs, node->x[1], node->y[1]);
+        else
+            bbSet(&search->theirs, mirror->x[i], mirror->y[i]);
+    }
+    bbCopy(&search->claimed, &search->mine);
+    bbOr(&search->claimed, &search->theirs);
+
+    int score = 0;
+    bool growing = true;
+    while (growing) {
+        growing = false;
+
+        bbDilate(&search->next, &search->mine);
+        bbCopy(&search->mine, &search->next);
+        bbDilate(&search->next, &search->theirs);
+        for (size_t i = 0; i < words; i++) {
+            uint64_t open = mirror->free.bits[i] & ~search->claimed.bits[i];
+            uint64_t m = search->mine.bits[i] & open;
+            uint64_t t = search->next.bits[i] & open;
+            uint64_t contested = m & t;
+            search->claimed.bits[i] |= m | t;
+            search->mine.bits[i] = m & ~contested;
+            search->theirs.bits[i] = t & ~contested;
+            growing |= (m | t) != 0;
+        }
+        score += (int)regionValue(mirror, &search->mine) - (int)regionValue(mirror, &search->theirs);
+    }
+    return score;
+}
+
+static int legalMoves(const Search *search, const SearchNode *node, int side, unsigned char *moves, unsigned char ttMove)
+{
+    BoardMirror *mirror = search->mirror;
+    unsigned int W = BB_WIDTH(&mirror->free), H = BB_HEIGHT(&mirror->free);
+    int count = 0;
+    for (int m = 0; m < 8; m++) {
+        int nx = node->x[side] + moveDx[m];
+        int ny = node->y[side] + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= (int)W || ny >= (int)H || !bbTest(&mirror->free, nx, ny))
+            continue;
+        moves[count++] = (unsigned char)m;
+    }
+
+    // Orden: jugada de la tabla primero y luego por valor de la celda destino
+    for (int i = 1; i < count; i++) {
+        unsigned char m = moves[i];
+        int key = m == ttMove ? 100 : mirror->cellValues[(node->y[side] + moveDy[m]) * W + node->x[side] + moveDx[m]];
+        int j = i - 1;
+        while (j >= 0) {
+            unsigned char o = moves[j];
+            int okey = o == ttMove ? 100 : mirror->cellValues[(node->y[side] + moveDy[o]) * W + node->x[side] + moveDx[o]];
+            if (okey >= key)
+                break;
+            moves[j + 1] = o;
+            j--;
+        }
+        moves[j + 1] = m;
+    }
+    return count;
+}
+
+static int alphaBeta(Search *search, SearchNode *node, int depth, int side, int alpha, int beta)
+{
+    if (timeIsUp(search))
+        return 0;
+    if (depth == 0)
+        return node->pathScore + voronoiScore(search, node);
+
+    BoardMirror *mirror = search->mirror;
+    unsigned int W = BB_WIDTH(&mirror->free);
+    uint64_t key = node->hash ^ (side ? search->zobristSide : 0);
+    TTEntry *entry = &search->table[key & (((uint64_t)1 << TT_BITS) - 1)];
+    unsigned char ttMove = 8;
+    if (entry->key == key) {
+        ttMove = entry->move;
+        if (entry->depth >= depth) {
+            int value = entry->value + node->pathScore;
+            if (entry->flag == TT_EXACT ||
+                (entry->flag == TT_LOWER && value >= beta) ||
+                (entry->flag == TT_UPPER && value <= alpha))
+                return value;
+        }
+    }
+
+    int nextSide = search->opponent >= 0 ? 1 - side : 0;
+    unsigned char moves[8];
+    int count = legalMoves(search, node, side, moves, ttMove);
+    if (count == 0) {
+        // Sin movimientos: el lado pasa; si el otro tampoco puede mover, es terminal
+        unsigned char other[8];
+        if (nextSide == side || legalMoves(search, node, nextSide, other, 8) == 0)
+            return node->pathScore + voronoiScore(search, node);
+        return alphaBeta(search, node, depth - 1, nextSide, alpha, beta);
+    }
+
+    int alphaOrig = alpha, betaOrig = beta;
+    int best = side == 0 ? -1000000 : 1000000;
+    unsigned char bestMove = moves[0];
+    for (int i = 0; i < count && !search->aborted; i++) {
+        int px = node->x[side], py = node->y[side];
+        int nx = px + moveDx[moves[i]], ny = py + moveDy[moves[i]];
+        unsigned int cell = ny * W + nx;
+        int gain = mirror->cellValues[cell];
+
+        bbReset(&mirror->free, nx, ny);
+        node->x[side] = nx;
+        node->y[side] = ny;
+        node->pathScore += side == 0 ? gain : -gain;
+        node->hash ^= search->zobristCell[cell] ^ positionKey(search, side, py * W + px) ^ positionKey(search, side, cell);
+
+        int value = alphaBeta(search, node, depth - 1, nextSide, alpha, beta);
+
+        node->hash ^= search->zobristCell[cell] ^ positionKey(search, side, py * W + px) ^ positionKey(search, side, cell);
+        node->pathScore -= side == 0 ? gain : -gain;
+        node->x[side] = px;
+        node->y[side] = py;
+        bbSet(&mirror->free, nx, ny);
+
+        if (side == 0 ? value > best : value < best) {
+            best = value;
+            bestMove = moves[i];
+        }
+        if (side == 0 && best > alpha)
+            alpha = best;
+        if (side == 1 && best < beta)
+            beta = best;
+        if (alpha >= beta)
+            break;
+    }
+
+    if (!search->aborted) {
+        entry->key = key;
+        entry->value = best - node->pathScore;
+        entry->depth = (unsigned char)depth;
+        entry->move = bestMove;
+        entry->flag = best <= alphaOrig ? TT_UPPER : best >= betaOrig ? TT_LOWER : TT_EXACT;
+    }
+    return best;
+}
+
+// Profundización iterativa hasta agotar el plazo; devuelve la mejor jugada de la
+// última profundidad completa (o la evaluada por inundación si no llegó a ninguna).
+unsigned char searchMovement(Search *search, int self, unsigned int budgetMs, struct timespec start)
+{
+    BoardMirror *mirror = search->mirror;
+    unsigned int W = BB_WIDTH(&mirror->free);
+
+    search->self = self;
+    search->aborted = false;
+    search->deadline = deadlineAfter(start, budgetMs);
+
+    // Oponente más cercano que todavía pueda moverse; si ninguno está a distancia
+    // SEARCH_NEARBY_DISTANCE o menos la búsqueda ramifica solo los movimientos propios
+    search->opponent = -1;
+    int nearest = SEARCH_NEARBY_DISTANCE + 1;
+    for (unsigned int i = 0; i < GRID_PLAYERS(mirror->playersNumber); i++) {
+        if ((int)i == self || mirror->blocked[i])
+            continue;
+        int dx = abs(mirror->x[i] - mirror->x[self]);
+        int dy = abs(mirror->y[i] - mirror->y[self]);
+        int distance = dx > dy ? dx : dy;
+        if (distance < nearest) {
+            nearest = distance;
+            search->opponent = (int)i;
+        }
+    }
+
+    SearchNode root;
+    root.x[0] = mirror->x[self];
+    root.y[0] = mirror->y[self];
+    root.x[1] = search->opponent >= 0 ? mirror->x[search->opponent] : 0;
+    root.y[1] = search->opponent >= 0 ? mirror->y[search->opponent] : 0;
+    root.pathScore = 0;
+    root.hash = positionKey(search, 0, root.y[0] * W + root.x[0]);
+    if (search->opponent >= 0)
+        root.hash ^= positionKey(search, 1, root.y[1] * W + root.x[1]);
+    // voronoiScore también lee las cabezas de los oponentes fijos: sin ellas en la
+    // clave, una entrada de un turno anterior devolvería un puntaje de otra posición
+    for (unsigned int i = 0; i < GRID_PLAYERS(mirror->playersNumber); i++) {
+        if ((int)i != self && (int)i != search->opponent && !mirror->blocked[i])
+            root.hash ^= positionKey(search, 2, mirror->y[i] * W + mirror->x[i]);
+    }
+    for (size_t i = 0; i < (size_t)W * BB_HEIGHT(&mirror->free); i++) {
+        if (mirror->cellValues[i] == 0)
+            root.hash ^= search->zobristCell[i];
+    }
+
+    unsigned char movement = chooseMovement(mirror, root.x[0], root.y[0]);
+    if (movement > 7)
+        return movement;
+
+    for (int depth = 1; depth <= SEARCH_MAX_DEPTH; depth++) {
+        alphaBeta(search, &root, depth, 0, -1000000, 1000000);
+        if (search->aborted)
+            break;
+        uint64_t key = root.hash;
+        TTEntry *entry = &search->table[key & (((uint64_t)1 << TT_BITS) - 1)];
+        if (entry->key == key && entry->move < 8)
+            movement = entry->move;
+    }
+    return movement;
+}
+#endif
+
+#ifdef PLAYER_MONTECARLO
+static uint64_t xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static RolloutBoard *boardPoolGet(RolloutWorker *worker)
+{
+    if (worker->freeBoards == NULL) {
+        RolloutBoard *chunk = malloc(MC_POOL_CHUNK * sizeof(RolloutBoard));
+        if (chunk == NULL)
+            return NULL;
+        for (int i = 0; i < MC_POOL_CHUNK; i++) {
+            chunk[i].nextFree = worker->freeBoards;
+            worker->freeBoards = &chunk[i];
+        }
     }
-    sem_post(&semaphore->mutexPlayerAccess);
+    RolloutBoard *board = worker->freeBoards;
+    worker->freeBoards = board->nextFree;
+    return board;
 }
 
-void releaseGameStatePlayerLock(Semaphores *semaphore)
+static void boardPoolPut(RolloutWorker *worker, RolloutBoard *board)
 {
-    sem_wait(&semaphore->mutexPlayerAccess);
-    if (--semaphore->playersReadingState == 0) {
-        sem_post(&semaphore->mutexGameState); // el último lector en salir libera el mutex
+    board->nextFree = worker->freeBoards;
+    worker->freeBoards = board;
+}
+
+static bool queuePush(RolloutWorker *worker, RolloutTask task)
+{
+    pthread_mutex_lock(&worker->queueLock);
+    bool pushed = worker->tail - worker->head < MC_QUEUE_SIZE;
+    if (pushed)
+        worker->queue[worker->tail++ % MC_QUEUE_SIZE] = task;
+    pthread_mutex_unlock(&worker->queueLock);
+    return pushed;
+}
+
+static bool queuePop(RolloutWorker *worker, RolloutTask *task)
+{
+    pthread_mutex_lock(&worker->queueLock);
+    bool popped = worker->tail > worker->head;
+    if (popped)
+        *task = worker->queue[--worker->tail % MC_QUEUE_SIZE];
+    pthread_mutex_unlock(&worker->queueLock);
+    return popped;
+}
+
+static bool queueSteal(RolloutWorker *victim, RolloutTask *task)
+{
+    if (pthread_mutex_trylock(&victim->queueLock) != 0)
+        return false;
+    bool stolen = victim->tail > victim->head;
+    if (stolen)
+        *task = victim->queue[victim->head++ % MC_QUEUE_SIZE];
+    pthread_mutex_unlock(&victim->queueLock);
+    return stolen;
+}
+
+// Elige un vecino libre: la mayoría de las veces el de más valor, si no uno al azar
+static int rolloutStep(const RolloutBoard *board, int x, int y, uint64_t *rng)
+{
+    int options[8], count = 0, best = -1, bestValue = 0;
+    for (int m = 0; m < 8; m++) {
+        int nx = x + moveDx[m], ny = y + moveDy[m];
+        if (nx < 0 || ny < 0 || nx >= MC_SIDE || ny >= MC_SIDE)
+            continue;
+        int value = board->cells[ny * MC_SIDE + nx];
+        if (value == 0)
+            continue;
+        options[count++] = m;
+        if (value > bestValue) {
+            bestValue = value;
+            best = m;
+        }
+    }
+    if (count == 0)
+        return -1;
+    uint64_t r = xorshift64(rng);
+    if ((r & 3) != 0)
+        return best;
+    return options[(r >> 2) % (uint64_t)count];
+}
+
+// Una simulación: se aplica el candidato y se alternan pasos de los oponentes
+// cercanos y propios; el resultado es lo capturado por el jugador.
+static double rollout(RolloutPool *pool, RolloutWorker *worker, RolloutBoard *board, unsigned char candidate)
+{
+    memcpy(board->cells, pool->snapshot.cells, sizeof(board->cells));
+    int x = MC_RADIUS + moveDx[candidate], y = MC_RADIUS + moveDy[candidate];
+    double collected = board->cells[y * MC_SIDE + x];
+    board->cells[y * MC_SIDE + x] = 0;
+
+    int ox[MAX_PLAYERS], oy[MAX_PLAYERS];
+    memcpy(ox, pool->opponentX, sizeof(ox));
+    memcpy(oy, pool->opponentY, sizeof(oy));
+
+    for (int step = 0; step < MC_HORIZON; step++) {
+        for (int i = 0; i < pool->opponents; i++) {
+            int m = rolloutStep(board, ox[i], oy[i], &worker->rng);
+            if (m >= 0) {
+                ox[i] += moveDx[m];
+                oy[i] += moveDy[m];
+                board->cells[oy[i] * MC_SIDE + ox[i]] = 0;
+            }
+        }
+        int m = rolloutStep(board, x, y, &worker->rng);
+        if (m < 0)
+            break;
+        x += moveDx[m];
+        y += moveDy[m];
+        collected += board->cells[y * MC_SIDE + x];
+        board->cells[y * MC_SIDE + x] = 0;
+    }
+    return collected;
+}
+
+static void *rolloutWorkerMain(void *arg)
+{
+    RolloutWorker *worker = arg;
+    RolloutPool *pool = worker->pool;
+    int self = (int)(worker - pool->workers);
+    unsigned long seen = 0;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        unsigned long done = 0;
+        int nextCandidate = self;
+        while (!pastDeadline(&pool->deadline)) {
+            RolloutTask task;
+            bool found = queuePop(worker, &task);
+            for (int k = 1; !found && k < pool->threads; k++) {
+                found = queueSteal(&pool->workers[(self + k) % pool->threads], &task);
+                if (found)
+                    worker->steals++;
+            }
+            if (!found) {
+                // Sin trabajo en ninguna cola: se generan lotes nuevos para los candidatos
+                for (int i = 0; i < pool->candidatesCount; i++) {
+                    RolloutTask fresh = {pool->candidates[(nextCandidate + i) % pool->candidatesCount], MC_BATCH};
+                    queuePush(worker, fresh);
+                }
+                nextCandidate++;
+                continue;
+            }
+
+            RolloutBoard *board = boardPoolGet(worker);
+            if (board == NULL)
+                break;
+            for (unsigned short r = 0; r < task.rollouts; r++) {
+                worker->sum[task.candidate] += rollout(pool, worker, board, task.candidate);
+                worker->count[task.candidate]++;
+            }
+            boardPoolPut(worker, board);
+            done += task.rollouts;
+        }
+        // Las tareas que quedaron en la cola se descartan al terminar el turno
+        pthread_mutex_lock(&worker->queueLock);
+        worker->head = worker->tail = 0;
+        pthread_mutex_unlock(&worker->queueLock);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->totalRollouts += done;
+        pool->totalSteals += worker->steals;
+        worker->steals = 0;
+        pool->finished++;
+        pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+bool initRolloutPool(RolloutPool *pool, int threads)
+{
+    memset(pool, 0, sizeof(*pool));
+    pool->threads = threads;
+    pool->workers = calloc((size_t)threads, sizeof(RolloutWorker));
+    if (pool->workers == NULL)
+        return false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        RolloutWorker *worker = &pool->workers[i];
+        pthread_mutex_init(&worker->queueLock, NULL);
+        worker->pool = pool;
+        worker->rng = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1) ^ (uint64_t)getpid();
+        if (pthread_create(&worker->thread, NULL, rolloutWorkerMain, worker) != 0)
+            return false;
+    }
+    return true;
+}
+
+void destroyRolloutPool(RolloutPool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->threads; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    if (pool->wallSeconds > 0) {
+        double rate = pool->totalRollouts / pool->wallSeconds;
+        fprintf(stderr, "player_mc: %lu rollouts con %d hilos (%lu robos), %.0f rollouts/s en total, %.0f por hilo\n",
+                pool->totalRollouts, pool->threads, pool->totalSteals, rate, rate / pool->threads);
+    }
+}
+
+unsigned char monteCarloMovement(RolloutPool *pool, BoardMirror *mirror, int self, unsigned int budgetMs, struct timespec start)
+{
+    unsigned int W = BB_WIDTH(&mirror->free), H = BB_HEIGHT(&mirror->free);
+    int x = mirror->x[self], y = mirror->y[self];
+
+    // Ventana centrada en la cabeza; lo que cae fuera del tablero queda bloqueado
+    for (int wy = 0; wy < MC_SIDE; wy++) {
+        for (int wx = 0; wx < MC_SIDE; wx++) {
+            int gx = x - MC_RADIUS + wx, gy = y - MC_RADIUS + wy;
+            bool inside = gx >= 0 && gy >= 0 && gx < (int)W && gy < (int)H;
+            pool->snapshot.cells[wy * MC_SIDE + wx] = inside ? mirror->cellValues[gy * W + gx] : 0;
+        }
+    }
+    pool->opponents = 0;
+    for (unsigned int i = 0; i < GRID_PLAYERS(mirror->playersNumber); i++) {
+        int ox = mirror->x[i] - x + MC_RADIUS, oy = mirror->y[i] - y + MC_RADIUS;
+        if ((int)i == self || mirror->blocked[i] || ox < 0 || oy < 0 || ox >= MC_SIDE || oy >= MC_SIDE)
+            continue;
+        pool->opponentX[pool->opponents] = ox;
+        pool->opponentY[pool->opponents] = oy;
+        pool->opponents++;
+    }
+
+    pool->candidatesCount = 0;
+    for (int m = 0; m < 8; m++) {
+        if (pool->snapshot.cells[(MC_RADIUS + moveDy[m]) * MC_SIDE + MC_RADIUS + moveDx[m]] > 0)
+            pool->candidates[pool->candidatesCount++] = (unsigned char)m;
+    }
+    if (pool->candidatesCount == 0)
+        return 9;
+    if (pool->candidatesCount == 1)
+        return pool->candidates[0];
+
+    // Reparto inicial de lotes en ronda entre las colas de los hilos
+    for (int t = 0; t < pool->threads; t++) {
+        RolloutWorker *worker = &pool->workers[t];
+        memset(worker->sum, 0, sizeof(worker->sum));
+        memset(worker->count, 0, sizeof(worker->count));
+        worker->head = worker->tail = 0;
+    }
+    for (int i = 0; i < pool->candidatesCount * 2; i++) {
+        RolloutTask task = {pool->candidates[i % pool->candidatesCount], MC_BATCH};
+        queuePush(&pool->workers[i % pool->threads], task);
+    }
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    pthread_mutex_lock(&pool->lock);
+    pool->deadline = deadlineAfter(start, budgetMs);
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->finished < pool->threads)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pool->wallSeconds += (double)(end.tv_sec - begin.tv_sec) + (double)(end.tv_nsec - begin.tv_nsec) / 1e9;
+
+    unsigned char movement = pool->candidates[0];
+    double bestAverage = -1;
+    for (int i = 0; i < pool->candidatesCount; i++) {
+        unsigned char m = pool->candidates[i];
+        double sum = 0;
+        unsigned long count = 0;
+        for (int t = 0; t < pool->threads; t++) {
+            sum += pool->workers[t].sum[m];
+            count += pool->workers[t].count[m];
+        }
+        if (count > 0 && sum / count > bestAverage) {
+            bestAverage = sum / count;
+            movement = m;
+        }
     }
-    sem_post(&semaphore->mutexPlayerAccess);
+    return movement;
 }
+#endif
@@ -0,0 +1,83 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// Caso fijo para la detección de partida decidida (-e end|fast) del master: se
+// reutilizan sus funciones incluyendo master.c con su main renombrado.
+#define main masterMain
+#include "master.c"
+#undef main
+
+// Tablero 7x5 ('#' capturada, '.' libre, A y J cabezas de los jugadores 0 y 1).
+// J toca la columna izquierda y, por T, la región de A. A baja a (3,2) en la ronda 1
+// y captura T en la ronda 2: J queda separado de A aunque las vecinas de T sigan
+// formando un solo grupo, así que la partida tiene que quedar decidida en la ronda 2.
+static const char *checkBoard[] = {
+    "#######",
+    ".###A..",
+    ".JT....",
+    ".##....",
+    "#######",
+};
+
+#define CHECK_W 7
+#define CHECK_H 5
+
+static void checkMove(RegionTracker *tracker, GameState *gameState, unsigned int player, int toX, int toY)
+{
+    Player *p = &gameState->players[player];
+    int fromX = p->x, fromY = p->y;
+    p->score += gameState->grid[toY * CHECK_W + toX];
+    p->valid++;
+    gameState->grid[toY * CHECK_W + toX] = -(int)player;
+    p->x = (unsigned short)toX;
+    p->y = (unsigned short)toY;
+    regionsCapture(tracker, gameState, fromX, fromY, toX, toY);
+}
+
+int main(void)
+{
+    GameState *gameState = calloc(1, sizeof(GameState) + CHECK_W * CHECK_H * sizeof(int));
+    if (gameState == NULL)
+    {
+        fprintf(stderr, "Sin memoria para el tablero\n");
+        return 1;
+    }
+    gameState->width = CHECK_W;
+    gameState->height = CHECK_H;
+    gameState->playersNumber = 2;
+    for (int y = 0; y < CHECK_H; y++)
+    {
+        for (int x = 0; x < CHECK_W; x++)
+        {
+            char c = checkBoard[y][x];
+            int player = c == 'A' ? 0 : c == 'J' ? 1 : -1;
+            gameState->grid[y * CHECK_W + x] = c == '#' ? 0 : player >= 0 ? -player : 1;
+            if (player >= 0)
+            {
+                gameState->players[player].x = (unsigned short)x;
+                gameState->players[player].y = (unsigned short)y;
+            }
+        }
+    }
+
+    RegionTracker tracker;
+    if (!initRegions(&tracker, gameState))
+    {
+        fprintf(stderr, "Sin memoria para el análisis de regiones\n");
+        return 1;
+    }
+
+    // Ronda 1: A en (4,1) baja a (3,2); J sigue alcanzando la región de A por T
+    checkMove(&tracker, gameState, 0, 3, 2);
+    bool decidedFirst = regionsDecided(&tracker, gameState);
+    // Ronda 2: A captura T en (2,2)
+    checkMove(&tracker, gameState, 0, 2, 2);
+    bool decidedSecond = regionsDecided(&tracker, gameState);
+
+    bool ok = !decidedFirst && decidedSecond;
+    printf("Regiones: ronda 1 %s, ronda 2 %s (%u análisis): %s\n", decidedFirst ? "decidida" : "abierta",
+           decidedSecond ? "decidida" : "abierta", tracker.analyses, ok ? "ok" : "FALLA");
+    freeRegions(&tracker);
+    free(gameState);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/select.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+
+// Generador de carga: corre varias partidas del master contra jugadores de
+// stress_player con modos al azar y stress_vista como vista verificadora.
+// Informa el rendimiento del master (turnos/s según su propio resumen) y si se
+// cumplieron los invariantes. Se ejecuta desde el directorio de los binarios.
+
+#define DRIVER_MAX_PLAYERS 9
+#define DRIVER_OUTPUT 65536
+#define DRIVER_GAME_LIMIT 60 // segundos antes de considerar colgada una partida
+
+static const char *driverModes[] = {"instant", "burst", "garbage", "hog", "crash", "mix"};
+#define DRIVER_MODES (sizeof(driverModes) / sizeof(driverModes[0]))
+
+typedef struct
+{
+    unsigned long turns;
+    double seconds;
+    unsigned long frames, violations;
+    int viewExit;
+    bool hung;
+    bool masterFailed;
+} GameResult;
+
+bool createModeLinks(char *dir, size_t dirSize);
+void removeModeLinks(const char *dir);
+GameResult runGame(char *const masterArgv[]);
+void parseMasterOutput(const char *output, GameResult *result);
+
+int main(int argc, char *argv[])
+{
+    unsigned int games = 10, width = 30, height = 30, maxPlayers = DRIVER_MAX_PLAYERS, seed = (unsigned int)time(NULL);
+    const char *moveTimeout = "50";
+    bool verify = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-h") && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            maxPlayers = atoi(argv[++i]);
+            if (maxPlayers < 1 || maxPlayers > DRIVER_MAX_PLAYERS) {
+                maxPlayers = DRIVER_MAX_PLAYERS;
+            }
+        } else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            moveTimeout = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-q")) {
+            verify = false; // sin vista: mide solo al master
+        } else {
+            fprintf(stderr, "Uso: %s [-g partidas] [-w width] [-h height] [-p max_jugadores] [-m move_timeout_ms] [-s seed] [-q]\n", argv[0]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    char linkDir[64];
+    if (!createModeLinks(linkDir, sizeof(linkDir))) {
+        return 1;
+    }
+
+    char wbuf[16], hbuf[16];
+    snprintf(wbuf, sizeof(wbuf), "%u", width);
+    snprintf(hbuf, sizeof(hbuf), "%u", height);
+
+    unsigned long totalTurns = 0, totalViolations = 0;
+    double totalSeconds = 0;
+    unsigned int failed = 0;
+
+    printf("%-7s %-52s %10s %10s %10s %s\n", "partida", "jugadores", "turnos", "turnos/s", "cuadros", "resultado");
+    for (unsigned int g = 0; g < games; g++) {
+        unsigned int playersCount = 2 + (maxPlayers > 2 ? (unsigned int)rand() % (maxPlayers - 1) : 0);
+        if (playersCount > maxPlayers) {
+            playersCount = maxPlayers;
+        }
+
+        char seedBuf[16];
+        snprintf(seedBuf, sizeof(seedBuf), "%d", rand());
+        char playerPaths[DRIVER_MAX_PLAYERS][PATH_MAX];
+        char description[128] = "";
+        char *masterArgv[32];
+        int n = 0;
+        masterArgv[n++] = "./master";
+        masterArgv[n++] = "-d";
+        masterArgv[n++] = "0";
+        masterArgv[n++] = "-t";
+        masterArgv[n++] = "2";
+        masterArgv[n++] = "-m";
+        masterArgv[n++] = (char *)moveTimeout;
+        masterArgv[n++] = "-w";
+        masterArgv[n++] = wbuf;
+        masterArgv[n++] = "-h";
+        masterArgv[n++] = hbuf;
+        masterArgv[n++] = "-s";
+        masterArgv[n++] = seedBuf;
+        if (verify) {
+            masterArgv[n++] = "-v";
+            masterArgv[n++] = "./stress_vista";
+        }
+        masterArgv[n++] = "-p";
+        for (unsigned int p = 0; p < playersCount; p++) {
+            const char *mode = driverModes[rand() % DRIVER_MODES];
+            snprintf(playerPaths[p], sizeof(playerPaths[p]), "%s/stress_player-%s", linkDir, mode);
+            masterArgv[n++] = playerPaths[p];
+            size_t used = strlen(description);
+            snprintf(description + used, sizeof(description) - used, "%s%s", p ? "," : "", mode);
+        }
+        masterArgv[n] = NULL;
+
+        GameResult result = runGame(masterArgv);
+        bool ok = !result.hung && !result.masterFailed && (!verify || (result.viewExit == 0 && result.violations == 0));
+        if (!ok) {
+            failed++;
+        }
+        totalTurns += result.turns;
+        totalSeconds += result.seconds;
+        totalViolations += result.violations;
+
+        printf("%-7u %-52s %10lu %10.0f %10lu %s\n", g + 1, description, result.turns,
+               result.seconds > 0 ? result.turns / result.seconds : 0.0, result.frames,
+               result.hung ? "COLGADA" : result.masterFailed ? "MASTER FALLÓ" : ok ? "ok" : "VIOLACIONES");
+        fflush(stdout);
+    }
+
+    printf("\n%u partidas, %u con fallas, %lu violaciones de invariantes, %lu turnos en %.2f s (%.0f turnos/s)\n",
+           games, failed, totalViolations, totalTurns, totalSeconds, totalSeconds > 0 ? totalTurns / totalSeconds : 0.0);
+
+    removeModeLinks(linkDir);
+    return failed > 0 ? 1 : 0;
+}
+
+// Un enlace por modo hacia stress_player, así el modo viaja en argv[0]
+bool createModeLinks(char *dir, size_t dirSize)
+{
+    char target[PATH_MAX];
+    if (realpath("./stress_player", target) == NULL) {
+        fprintf(stderr, "No se encontró ./stress_player: %s\n", strerror(errno));
+        return false;
+    }
+    snprintf(dir, dirSize, "/tmp/stress_playersXXXXXX");
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return false;
+    }
+    for (size_t m = 0; m < DRIVER_MODES; m++) {
+        char link[PATH_MAX];
+        snprintf(link, sizeof(link), "%s/stress_player-%s", dir, driverModes[m]);
+        if (symlink(target, link) == -1) {
+            perror("symlink");
+            return false;
+        }
+    }
+    return true;
+}
+
+void removeModeLinks(const char *dir)
+{
+    for (size_t m = 0; m < DRIVER_MODES; m++) {
+        char link[PATH_MAX];
+        snprintf(link, sizeof(link), "%s/stress_player-%s", dir, driverModes[m]);
+        unlink(link);
+    }
+    rmdir(dir);
+}
+
+// Corre una partida en su propio grupo de procesos; si no termina a tiempo se
+// mata el grupo entero y se limpian las memorias compartidas que dejó el master.
+GameResult runGame(char *const masterArgv[])
+{
+    GameResult result;
+    memset(&result, 0, sizeof(result));
+    result.viewExit = -1;
+
+    int out[2];
+    if (pipe(out) == -1) {
+        perror("pipe");
+        result.masterFailed = true;
+        return result;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork master");
+        result.masterFailed = true;
+        return result;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        dup2(out[1], STDOUT_FILENO);
+        close(out[0]);
+        close(out[1]);
+        execv(masterArgv[0], masterArgv);
+        fprintf(stderr, "execv master: %s\n", strerror(errno));
+        exit(127);
+    }
+    setpgid(pid, pid);
+    close(out[1]);
+
+    char *output = malloc(DRIVER_OUTPUT);
+    size_t used = 0;
+    time_t start = time(NULL);
+    while (output != NULL) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(out[0], &readfds);
+        struct timeval wait = {1, 0};
+        int ready = select(out[0] + 1, &readfds, NULL, NULL, &wait);
+        if (ready == -1 && errno != EINTR) {
+            break;
+        }
+        if (ready > 0) {
+            ssize_t n = read(out[0], output + used, DRIVER_OUTPUT - 1 - used);
+            if (n <= 0) {
+                break;
+            }
+            used += (size_t)n;
+            if (used == DRIVER_OUTPUT - 1) {
+                used = 0; // solo interesa el resumen final
+            }
+        }
+        if (time(NULL) - start > DRIVER_GAME_LIMIT) {
+            result.hung = true;
+            kill(-pid, SIGKILL);
+            shm_unlink("/game_state");
+            shm_unlink("/game_sync");
+            shm_unlink("/game_feed");
+            shm_unlink("/game_hints");
+            break;
+        }
+    }
+    close(out[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!result.hung && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+        result.masterFailed = true;
+    }
+    if (output != NULL) {
+        output[used] = '\0';
+        parseMasterOutput(output, &result);
+        free(output);
+    }
+    return result;
+}
+
+void parseMasterOutput(const char *output, GameResult *result)
+{
+    for (const char *line = output; line != NULL && *line; line = strchr(line, '\n')) {
+        if (*line == '\n') {
+            line++;
+        }
+        const char *turns = strstr(line, "turnos en ");
+        const char *planner = strncmp(line, "Planificador", 12) == 0 ? strchr(line, ':') : NULL;
+        if (planner != NULL && turns != NULL) {
+            sscanf(planner + 1, "%lu turnos en %lf s", &result->turns, &result->seconds);
+        }
+        sscanf(line, "Verificación: %lu cuadros, %lu violaciones", &result->frames, &result->violations);
+        sscanf(line, "Vista: Salió con código %d", &result->viewExit);
+    }
+}
@@ -0,0 +1,200 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "estructuras.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <errno.h>
+
+// Jugador adversario para medir al master. El modo sale de argv[3] o, como el
+// master solo pasa ancho y alto, del sufijo del nombre del ejecutable después
+// del último '-' (stress_driver crea enlaces stress_player-burst, etc.):
+//   instant  responde apenas lo habilitan con la mejor vecina según las pistas del
+//            master (/game_hints) o, si no las hay, con una vecina libre al azar
+//   burst    escribe varios movimientos por turno
+//   garbage  escribe bytes fuera de rango o hacia celdas ocupadas o fuera del tablero
+//   hog      retiene el lock de lectores más de lo normal
+//   crash    termina (exit o SIGKILL) en un turno al azar, siempre fuera del lock
+//   mix      elige uno de los anteriores en cada turno
+
+#define STRESS_BURST_MAX 16
+#define STRESS_HOG_MICROS 5000
+#define STRESS_CRASH_ODDS 200 // probabilidad 1/STRESS_CRASH_ODDS por turno
+
+typedef enum
+{
+    STRESS_INSTANT,
+    STRESS_BURST,
+    STRESS_GARBAGE,
+    STRESS_HOG,
+    STRESS_CRASH,
+    STRESS_MIX,
+    STRESS_MODES
+} StressMode;
+
+static const char *stressModeNames[STRESS_MODES] = {"instant", "burst", "garbage", "hog", "crash", "mix"};
+
+static const int moveDx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int moveDy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+StressMode parseStressMode(int argc, char *argv[]);
+unsigned char freeNeighbours(const GameState *gameState, int x, int y, unsigned char *moves);
+unsigned char randomMove(const unsigned char *moves, unsigned char count);
+void writeMoves(const unsigned char *bytes, size_t count);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <width> <height> [instant|burst|garbage|hog|crash|mix]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned int width = (unsigned int)atoi(argv[1]);
+    unsigned int height = (unsigned int)atoi(argv[2]);
+    StressMode mode = parseStressMode(argc, argv);
+
+    GameState *gameState = connectToSharedMemoryState(width, height);
+    Semaphores *semaphores = connectToSharedMemorySemaphores();
+    HintIndex *hints = connectToSharedMemoryHints();
+
+    // Si el master cierra el pipe se termina con error de write en lugar de SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+    srand((unsigned int)getpid() ^ (unsigned int)time(NULL));
+
+    int playerIndex = -1;
+    for (int attempt = 0; attempt < 1000 && playerIndex == -1; attempt++) {
+        for (int i = 0; i < MAX_PLAYERS && playerIndex == -1; i++) {
+            if (gameState->players[i].pid == getpid()) {
+                playerIndex = i;
+            }
+        }
+        if (playerIndex == -1) {
+            usleep(1000);
+        }
+    }
+    if (playerIndex == -1) {
+        fprintf(stderr, "No se encontró el índice del jugador para el PID actual\n");
+        return 1;
+    }
+
+    while (1) {
+        sem_wait(&semaphores->playerCanMove[playerIndex]);
+
+        StressMode turnMode = mode;
+        if (mode == STRESS_MIX) {
+            turnMode = (StressMode)(rand() % STRESS_MIX);
+        }
+
+        if (turnMode == STRESS_CRASH && rand() % STRESS_CRASH_ODDS == 0) {
+            if (rand() % 2) {
+                raise(SIGKILL);
+            }
+            exit(3);
+        }
+
+        unsigned char moves[8], count, hinted = HINT_NONE;
+        acquireGameStatePlayerLock(semaphores);
+        if (turnMode == STRESS_INSTANT && hints != NULL) {
+            hinted = hints->players[playerIndex].bestMove;
+            count = 0; // con pista no se recorren las vecinas
+        } else {
+            count = freeNeighbours(gameState, gameState->players[playerIndex].x, gameState->players[playerIndex].y, moves);
+        }
+        if (turnMode == STRESS_HOG) {
+            usleep(STRESS_HOG_MICROS);
+        }
+        bool isOver = gameState->gameOver;
+        releaseGameStatePlayerLock(semaphores);
+
+        if (isOver) {
+            break;
+        }
+
+        unsigned char bytes[STRESS_BURST_MAX];
+        size_t written = 1;
+        switch (turnMode) {
+        case STRESS_BURST:
+            written = 2 + (size_t)(rand() % (STRESS_BURST_MAX - 1));
+            for (size_t k = 0; k < written; k++) {
+                bytes[k] = randomMove(moves, count);
+            }
+            break;
+        case STRESS_GARBAGE:
+            if (rand() % 2) {
+                bytes[0] = (unsigned char)(8 + rand() % 248);
+            } else {
+                // Una dirección que no esté entre las libres (ocupada o fuera del tablero)
+                bytes[0] = (unsigned char)(rand() % 8);
+                for (unsigned char k = 0; k < count; k++) {
+                    if (moves[k] == bytes[0]) {
+                        bytes[0] = 8;
+                        break;
+                    }
+                }
+            }
+            break;
+        default:
+            bytes[0] = hinted != HINT_NONE ? hinted : randomMove(moves, count);
+            break;
+        }
+        writeMoves(bytes, written);
+    }
+
+    return 0;
+}
+
+StressMode parseStressMode(int argc, char *argv[])
+{
+    const char *name = argc > 3 ? argv[3] : strrchr(argv[0], '-');
+    if (name == NULL) {
+        return STRESS_MIX;
+    }
+    if (*name == '-') {
+        name++;
+    }
+    for (int m = 0; m < STRESS_MODES; m++) {
+        if (!strcmp(name, stressModeNames[m])) {
+            return (StressMode)m;
+        }
+    }
+    fprintf(stderr, "Modo de estrés desconocido '%s', se usa mix\n", name);
+    return STRESS_MIX;
+}
+
+unsigned char freeNeighbours(const GameState *gameState, int x, int y, unsigned char *moves)
+{
+    unsigned char count = 0;
+    for (unsigned char m = 0; m < 8; m++) {
+        int nx = x + moveDx[m], ny = y + moveDy[m];
+        if (nx >= 0 && ny >= 0 && nx < gameState->width && ny < gameState->height &&
+            gameState->grid[ny * gameState->width + nx] > 0) {
+            moves[count++] = m;
+        }
+    }
+    return count;
+}
+
+unsigned char randomMove(const unsigned char *moves, unsigned char count)
+{
+    return count > 0 ? moves[rand() % count] : (unsigned char)(rand() % 8);
+}
+
+void writeMoves(const unsigned char *bytes, size_t count)
+{
+    size_t done = 0;
+    while (done < count) {
+        ssize_t n = write(STDOUT_FILENO, bytes + done, count - done);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            exit(errno == EPIPE ? 0 : 1); // el master ya cerró el pipe
+        }
+        done += (size_t)n;
+    }
+}
@@ -0,0 +1,142 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "estructuras.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <errno.h>
+
+// Vista verificadora para las pruebas de estrés: no dibuja nada, compara cada
+// cuadro (que puede juntar varias rondas) con el anterior y comprueba los invariantes del master:
+//   - una celda capturada no vuelve a cambiar (nadie captura dos veces),
+//   - una celda libre no cambia de valor,
+//   - el puntaje de cada jugador es la suma de los valores que capturó,
+//   - los movimientos válidos son la cantidad de celdas que capturó,
+//   - la cabeza de cada jugador está sobre una celda suya.
+// Sale con código 1 si encontró alguna violación.
+
+#define MAX_REPORTED 10 // violaciones detalladas por stderr
+
+typedef struct
+{
+    int *previous;
+    unsigned long long expectedScore[MAX_PLAYERS];
+    unsigned int expectedValid[MAX_PLAYERS];
+    unsigned long frames;
+    unsigned long violations;
+} Checker;
+
+void violation(Checker *checker, const char *format, unsigned int a, unsigned int b, long long c);
+void checkFrame(Checker *checker, const GameState *gameState, bool first);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <width> <height>\n", argv[0]);
+        return 1;
+    }
+
+    unsigned int width = atoi(argv[1]);
+    unsigned int height = atoi(argv[2]);
+
+    GameState *gameState = connectToSharedMemoryState(width, height);
+    Semaphores *semaphores = connectToSharedMemorySemaphores();
+
+    Checker checker;
+    memset(&checker, 0, sizeof(checker));
+    checker.previous = malloc((size_t)width * height * sizeof(int));
+    if (checker.previous == NULL) {
+        fprintf(stderr, "Sin memoria para la vista verificadora\n");
+        return 1;
+    }
+
+    while (1)
+    {
+        if (sem_wait(&semaphores->pendingView) == -1)
+        {
+            fprintf(stderr, "stress_vista: sem_wait pendingView fallo errno=%d (%s)\n", errno, strerror(errno));
+            break;
+        }
+
+        // El master ya no espera a la vista: el lock de lectores congela el estado
+        // mientras se revisa, y las rondas intermedias llegan juntas en un cuadro
+        acquireGameStatePlayerLock(semaphores);
+        checkFrame(&checker, gameState, checker.frames == 0);
+        checker.frames++;
+        bool isOver = gameState->gameOver;
+        releaseGameStatePlayerLock(semaphores);
+
+        if (sem_post(&semaphores->viewEndedPrinting) == -1) {
+            fprintf(stderr, "stress_vista: sem_post viewEndedPrinting fallo errno=%d (%s)\n", errno, strerror(errno));
+        }
+
+        if (isOver)
+        {
+            break;
+        }
+    }
+
+    printf("Verificación: %lu cuadros, %lu violaciones\n", checker.frames, checker.violations);
+    fflush(stdout);
+    free(checker.previous);
+    return checker.violations > 0 ? 1 : 0;
+}
+
+void violation(Checker *checker, const char *format, unsigned int a, unsigned int b, long long c)
+{
+    if (checker->violations++ < MAX_REPORTED) {
+        fprintf(stderr, "stress_vista (cuadro %lu): ", checker->frames);
+        fprintf(stderr, format, a, b, c);
+        fprintf(stderr, "\n");
+    }
+}
+
+void checkFrame(Checker *checker, const GameState *gameState, bool first)
+{
+    unsigned int W = gameState->width, H = gameState->height;
+    unsigned int players = gameState->playersNumber;
+    const int *grid = gameState->grid;
+
+    if (!first) {
+        for (unsigned int pos = 0; pos < W * H; pos++) {
+            int before = checker->previous[pos], now = grid[pos];
+            if (before == now) {
+                continue;
+            }
+            if (before <= 0) {
+                violation(checker, "celda (%u, %u) capturada dos veces, ahora %lld", pos % W, pos / W, now);
+            } else if (now > 0) {
+                violation(checker, "celda libre (%u, %u) cambió de valor a %lld", pos % W, pos / W, now);
+            } else if ((unsigned int)-now >= players) {
+                violation(checker, "celda (%u, %u) capturada por un jugador inexistente %lld", pos % W, pos / W, -now);
+            } else {
+                checker->expectedScore[-now] += (unsigned int)before;
+                checker->expectedValid[-now]++;
+            }
+        }
+    }
+    memcpy(checker->previous, grid, (size_t)W * H * sizeof(int));
+
+    for (unsigned int i = 0; i < players && i < MAX_PLAYERS; i++) {
+        const Player *player = &gameState->players[i];
+        if (first) {
+            checker->expectedScore[i] = player->score;
+            checker->expectedValid[i] = player->valid;
+        }
+        if (player->score != checker->expectedScore[i]) {
+            violation(checker, "jugador %u: puntaje %u, suma de celdas capturadas %lld", i + 1, player->score,
+                      (long long)checker->expectedScore[i]);
+        }
+        if (player->valid != checker->expectedValid[i]) {
+            violation(checker, "jugador %u: %u movimientos válidos, %lld celdas capturadas", i + 1, player->valid,
+                      (long long)checker->expectedValid[i]);
+        }
+        if (player->x >= W || player->y >= H || grid[player->y * W + player->x] != -(int)i) {
+            violation(checker, "jugador %u: la cabeza en la celda %u no es propia (%lld)", i + 1,
+                      (unsigned int)player->y * W + player->x,
+                      player->x < W && player->y < H ? grid[player->y * W + player->x] : 0);
+        }
+    }
+}
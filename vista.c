@@ -14,11 +14,18 @@
 #include <stdbool.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <stdarg.h>
+#ifndef VISTA_HEADLESS
 #include <ncurses.h>
+#endif
 
 
+int initView(int argc, char *argv[], unsigned int width, unsigned int height);
 void printState(GameState *gameState);
+void endView(void);
+void waitNextFrame(struct timespec *nextFrame, unsigned int delayMs);
 
+#ifndef VISTA_HEADLESS
 static FILE *tty_in = NULL;
 static FILE *tty_out = NULL;
 static SCREEN *scr = NULL;
@@ -85,10 +92,26 @@ void endCurses()
     if (tty_out) { fclose(tty_out); tty_out = NULL; }
 }
 
+int initView(int argc, char *argv[], unsigned int width, unsigned int height)
+{
+    (void)argc; (void)argv; (void)width; (void)height;
+    return myInitscr();
+}
+
+void endView(void)
+{
+    endCurses();
+}
+#endif
+
 int main(int argc, char *argv[])
 {
     if (argc < 3) {
+#ifdef VISTA_HEADLESS
+        fprintf(stderr, "Uso: %s <width> <height> [archivo.cast]\n", argv[0]);
+#else
         fprintf(stderr, "Uso: %s <width> <height>\n", argv[0]);
+#endif
         return 1;
     }
 
@@ -98,8 +121,27 @@ int main(int argc, char *argv[])
     GameState *gameState = connectToSharedMemoryState(width, height);
     Semaphores *semaphores = connectToSharedMemorySemaphores();
 
-    if (myInitscr()) {
-        fprintf(stderr, "No se pudo inicializar ncurses vía /dev/tty. Saliendo.\n");
+    // Intervalo mínimo entre cuadros (-d del master). El master no espera a la
+    // vista: cada cuadro copia el estado más reciente bajo el lock de lectores, así
+    // que las rondas que pasan mientras se dibuja o se espera salen juntas. La
+    // grabación no puede perder rondas: pide que el master la espere y no se pausa.
+#ifdef VISTA_HEADLESS
+    semaphores->viewRecords = true;
+#else
+    const char *delayEnv = getenv("GAME_DELAY_MS");
+    unsigned int delayMs = delayEnv != NULL ? (unsigned int)atoi(delayEnv) : 0;
+    struct timespec nextFrame;
+    clock_gettime(CLOCK_MONOTONIC, &nextFrame);
+#endif
+    size_t stateSize = sizeof(GameState) + (size_t)width * height * sizeof(int);
+    GameState *snapshot = malloc(stateSize);
+    if (snapshot == NULL) {
+        fprintf(stderr, "vista: sin memoria para la copia del estado\n");
+        return 1;
+    }
+
+    if (initView(argc, argv, width, height)) {
+        fprintf(stderr, "No se pudo inicializar la vista. Saliendo.\n");
         return 1;
     }
 
@@ -112,23 +154,54 @@ int main(int argc, char *argv[])
             break;
         }
 
-        printState(gameState);
+        acquireGameStatePlayerLock(semaphores);
+        memcpy(snapshot, gameState, stateSize);
+        releaseGameStatePlayerLock(semaphores);
 
         if (sem_post(&semaphores->viewEndedPrinting) == -1) {
             fprintf(stderr, "vista: sem_post viewEndedPrinting fallo errno=%d (%s)\n", errno, strerror(errno));
         }
 
-        if (gameState->gameOver)
+        printState(snapshot);
+
+        if (snapshot->gameOver)
         {
             break;
         }
+#ifndef VISTA_HEADLESS
+        waitNextFrame(&nextFrame, delayMs);
+#endif
     }
 
-    endCurses();
+    endView();
+    free(snapshot);
 
     return 0;
 }
 
+// Duerme hasta el próximo cuadro según un reloj absoluto, así el tiempo de dibujo
+// no se suma al intervalo; si la vista viene atrasada no acumula cuadros debidos
+void waitNextFrame(struct timespec *nextFrame, unsigned int delayMs)
+{
+    if (delayMs == 0)
+        return;
+    nextFrame->tv_sec += delayMs / 1000;
+    nextFrame->tv_nsec += (long)(delayMs % 1000) * 1000000L;
+    if (nextFrame->tv_nsec >= 1000000000L) {
+        nextFrame->tv_sec++;
+        nextFrame->tv_nsec -= 1000000000L;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec > nextFrame->tv_sec || (now.tv_sec == nextFrame->tv_sec && now.tv_nsec >= nextFrame->tv_nsec)) {
+        *nextFrame = now;
+        return;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, nextFrame, NULL) == EINTR)
+        ;
+}
+
+#ifndef VISTA_HEADLESS
 void printState(GameState *gameState)
 {
     if (gameState == NULL)
@@ -194,3 +267,196 @@ void printState(GameState *gameState)
     printw("=======================\n\n");
     refresh();
 }
+#else
+// Backend sin terminal: cada frame se codifica como evento de un stream
+// asciicast v2 (https://docs.asciinema.org/manual/asciicast/v2/) sobre un
+// archivo con buffer. Solo se emiten las celdas que cambiaron respecto del
+// frame anterior, posicionando el cursor con secuencias ANSI.
+
+#define CELL_UNDRAWN (-1000)
+#define PLAYER_CODE_BASE 100
+
+static FILE *recording = NULL;
+static struct timespec recordingStart;
+static unsigned int recordingDelayMs = 0; // con -d, marca de tiempo de cada cuadro
+static unsigned long recordedFrames = 0;
+static int *drawnCells = NULL;           // código dibujado por celda en el frame anterior
+static Player drawnPlayers[MAX_PLAYERS];
+static bool drawnGameOver = false;
+static bool firstFrame = true;
+static char *frame = NULL;               // frame en construcción (sin escapar)
+static size_t frameLen = 0, frameCap = 0;
+
+// Atributos ANSI equivalentes a los pares de color de la vista ncurses
+static const char *playerColors[] = {
+    "31", "32", "33", "34", "35", "36", "32;47", "30;47", "31;47"
+};
+
+static void frameAppend(const char *fmt, ...)
+{
+    char chunk[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(chunk, sizeof(chunk), fmt, args);
+    va_end(args);
+    if (n < 0)
+        return;
+    if ((size_t)n >= sizeof(chunk))
+        n = sizeof(chunk) - 1;
+
+    if (frameLen + (size_t)n > frameCap) {
+        size_t newCap = frameCap ? frameCap * 2 : 4096;
+        while (newCap < frameLen + (size_t)n)
+            newCap *= 2;
+        char *grown = realloc(frame, newCap);
+        if (grown == NULL)
+            return;
+        frame = grown;
+        frameCap = newCap;
+    }
+    memcpy(frame + frameLen, chunk, (size_t)n);
+    frameLen += (size_t)n;
+}
+
+// Escribe el frame acumulado como un evento de salida con el string escapado para JSON
+static void frameFlush(void)
+{
+    if (frameLen == 0)
+        return;
+
+    // El master ya no va al ritmo de -d, así que con demora los cuadros se ubican a
+    // intervalos de -d para que la reproducción tenga la velocidad de antes
+    double elapsed;
+    if (recordingDelayMs > 0) {
+        elapsed = (double)recordedFrames * recordingDelayMs / 1000.0;
+    } else {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (double)(now.tv_sec - recordingStart.tv_sec) +
+                  (double)(now.tv_nsec - recordingStart.tv_nsec) / 1e9;
+    }
+
+    fprintf(recording, "[%.6f, \"o\", \"", elapsed);
+    for (size_t i = 0; i < frameLen; i++) {
+        unsigned char c = (unsigned char)frame[i];
+        if (c == '\x1b')
+            fputs("\\u001b", recording);
+        else if (c == '\n')
+            fputs("\\r\\n", recording);
+        else if (c == '"' || c == '\\') {
+            fputc('\\', recording);
+            fputc(c, recording);
+        } else
+            fputc(c, recording);
+    }
+    fputs("\"]\n", recording);
+    frameLen = 0;
+}
+
+int initView(int argc, char *argv[], unsigned int width, unsigned int height)
+{
+    const char *path = argc > 3 ? argv[3] : "partida.cast";
+
+    recording = fopen(path, "w");
+    if (recording == NULL) {
+        fprintf(stderr, "vista: no se pudo abrir %s (errno=%d %s)\n", path, errno, strerror(errno));
+        return 1;
+    }
+    setvbuf(recording, NULL, _IOFBF, 1 << 16);
+
+    drawnCells = malloc((size_t)width * height * sizeof(int));
+    if (drawnCells == NULL) {
+        fprintf(stderr, "vista: sin memoria para el frame anterior\n");
+        fclose(recording);
+        recording = NULL;
+        return 1;
+    }
+    for (size_t i = 0; i < (size_t)width * height; i++)
+        drawnCells[i] = CELL_UNDRAWN;
+
+    // Mismo layout que la vista ncurses: 3 columnas por celda y el bloque de jugadores debajo
+    fprintf(recording, "{\"version\": 2, \"width\": %u, \"height\": %u, \"timestamp\": %ld}\n",
+            width * 3 > 80 ? width * 3 : 80, height + MAX_PLAYERS + 8, (long)time(NULL));
+    clock_gettime(CLOCK_MONOTONIC, &recordingStart);
+    const char *delayEnv = getenv("GAME_DELAY_MS");
+    recordingDelayMs = delayEnv != NULL ? (unsigned int)atoi(delayEnv) : 0;
+    return 0;
+}
+
+void printState(GameState *gameState)
+{
+    if (gameState == NULL || recording == NULL)
+        return;
+
+    unsigned short W = gameState->width;
+    unsigned short H = gameState->height;
+
+    if (firstFrame) {
+        frameAppend("\x1b[2J\x1b[H=== ESTADO DEL JUEGO ===\n");
+        frameAppend("Tablero: %ux%u | Jugadores: %u\n", W, H, gameState->playersNumber);
+    }
+
+    // Código por celda: PLAYER_CODE_BASE + p si hay una cabeza, si no el valor de la grilla
+    int heads[MAX_PLAYERS];
+    for (unsigned int p = 0; p < gameState->playersNumber; p++)
+        heads[p] = gameState->players[p].y * W + gameState->players[p].x;
+
+    for (unsigned int y = 0; y < H; y++) {
+        for (unsigned int x = 0; x < W; x++) {
+            int pos = y * W + x;
+            int code = gameState->grid[pos];
+            for (unsigned int p = 0; p < gameState->playersNumber; p++) {
+                if (heads[p] == pos) {
+                    code = PLAYER_CODE_BASE + p;
+                    break;
+                }
+            }
+            if (code == drawnCells[pos])
+                continue;
+            drawnCells[pos] = code;
+
+            frameAppend("\x1b[%u;%uH", y + 3, x * 3 + 1);
+            if (code >= PLAYER_CODE_BASE)
+                frameAppend("\x1b[%smP%d \x1b[0m", playerColors[(code - PLAYER_CODE_BASE) % 9], code - PLAYER_CODE_BASE + 1);
+            else if (code <= 0)
+                frameAppend("\x1b[%sm%2d \x1b[0m", playerColors[-code % 9], -code + 1);
+            else
+                frameAppend("%2d ", code);
+        }
+    }
+
+    bool playersChanged = firstFrame || drawnGameOver != gameState->gameOver ||
+                          memcmp(drawnPlayers, gameState->players, sizeof(Player) * gameState->playersNumber) != 0;
+    if (playersChanged) {
+        frameAppend("\x1b[%u;1H\x1b[J\nJugadores:\n", H + 3);
+        for (unsigned int i = 0; i < gameState->playersNumber; i++) {
+            Player *pl = &gameState->players[i];
+            frameAppend("\x1b[%sm  %u: %s - Puntaje: %u, Pos: (%u,%u)%s Inválidos: %u Válidos: %u\x1b[0m\n",
+                        playerColors[i % 9], i + 1, pl->playerName, pl->score, pl->x, pl->y,
+                        pl->blocked ? " [BLOQ]" : "", pl->invalid, pl->valid);
+        }
+        if (gameState->gameOver)
+            frameAppend("\n*** JUEGO TERMINADO ***\n");
+        frameAppend("=======================\n");
+        memcpy(drawnPlayers, gameState->players, sizeof(Player) * gameState->playersNumber);
+        drawnGameOver = gameState->gameOver;
+    }
+
+    firstFrame = false;
+    frameFlush();
+    recordedFrames++;
+}
+
+void endView(void)
+{
+    if (recording) {
+        fclose(recording);
+        recording = NULL;
+    }
+    free(drawnCells);
+    drawnCells = NULL;
+    free(frame);
+    frame = NULL;
+    frameLen = frameCap = 0;
+}
+#endif